@@ -12,7 +12,7 @@ void JResult::add_noun(JNoun::Ptr noun) {
   ++nouns_ptr;
 }
   
-shared_ptr<JNoun> JResult::assemble_result() const { 
+JNoun::Ptr JResult::assemble_result() const { 
   assert(nouns_ptr == nouns.end());
 
   Dimensions cell_dims(find_common_dims_from_nouns(nouns.begin(), nouns.end()));
@@ -35,17 +35,17 @@ shared_ptr<JNoun> JResult::assemble_result() const {
 template <typename T> 
 JNoun::Ptr JResult::assemble_result_internal(const Dimensions& cell_dims) const {
   Dimensions res = frame + cell_dims;
-  shared_ptr<vector<T> > v(make_shared<vector<T> >(res.number_of_elems(), JTypeTrait<T>::base_elem()));
+  typename JBuffer<T>::Ptr v(JBuffer<T>::InstantiateFilled(res.number_of_elems(), JTypeTrait<T>::base_elem()));
   
-  typename vector<T>::iterator ptr(v->begin());
+  typename JBuffer<T>::iterator ptr(v->begin());
   typename JNounList::const_iterator nounlist_ptr(nouns.begin()), nounlist_end(nouns.end());
     
-  int cell_dims_len = cell_dims.number_of_elems();
+  JSize cell_dims_len = cell_dims.number_of_elems();
   for (;nounlist_ptr != nounlist_end; ++nounlist_ptr, ptr += cell_dims_len) {
     require_type<T>(**nounlist_ptr).extend_into(cell_dims, ptr);
   }
   
-  return boost::static_pointer_cast<JNoun>(make_shared<JArray<T> >(res, v));
+  return JNoun::Ptr(new JArray<T>(res, v));
 }
 
 }}
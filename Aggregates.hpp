@@ -149,64 +149,64 @@ optional<j_value_type> find_common_type_dropping_empty(Iterator in_begin, Iterat
   return find_common_type(value_type_iter.first, value_type_iter.second);
 }
   
-template <typename Iterator>
-Dimensions find_common_dims_from_nouns(Iterator begin, Iterator end) {
-  typedef get_dimensions<Iterator> get_dims;
-  typename get_dims::result_type dims_iters(get_dims()(begin, end));
-  
-  return find_common_dims(dims_iters.first, dims_iters.second);
-}
-  
 template <typename Iterator>
 Dimensions find_common_dims(Iterator iter, Iterator end) { 
   assert(iter != end);
   
-  shared_ptr<vector<int> > dim_cand(make_shared<vector<int> >(iter->begin(), iter->end()));
+  const Dimensions& first_dims = *iter;
+  shared_ptr<vector<JSize> > dim_cand(make_shared<vector<JSize> >(first_dims.begin(), first_dims.end()));
   ++iter;
   for(;iter != end; ++iter) { 
     const Dimensions& dims = *iter;
     int rank_diff = dim_cand->size() - dims.get_rank();
     if(rank_diff >= 0) {
       transform(dim_cand->begin() + rank_diff, dim_cand->end(), dims.begin(), 
-		dim_cand->begin() + rank_diff, boost::bind(&std::max<int>, _1, _2));
+		dim_cand->begin() + rank_diff, boost::bind(&std::max<JSize>, _1, _2));
       transform(dim_cand->begin(), dim_cand->begin() + rank_diff, 
-		dim_cand->begin(), boost::bind(&std::max<int>, 1, _1));
+		dim_cand->begin(), boost::bind(&std::max<JSize>, JSize(1), _1));
     } else {
       dim_cand->insert(dim_cand->begin(), dims.begin(), dims.begin() - rank_diff);
       transform(dim_cand->begin(), dim_cand->begin() - rank_diff, dim_cand->begin(),
-		boost::bind(&std::max<int>, _1, 1));
+		boost::bind(&std::max<JSize>, _1, JSize(1)));
       transform(dim_cand->begin() - rank_diff, dim_cand->end(), dims.begin() - rank_diff,
-		dim_cand->begin() - rank_diff, boost::bind(&std::max<int>, _1, _2));
+		dim_cand->begin() - rank_diff, boost::bind(&std::max<JSize>, _1, _2));
     }
   }
   
   return Dimensions(dim_cand);
 }
 
+template <typename Iterator>
+Dimensions find_common_dims_from_nouns(Iterator begin, Iterator end) {
+  typedef get_dimensions<Iterator> get_dims;
+  typename get_dims::result_type dims_iters(get_dims()(begin, end));
+  
+  return find_common_dims(dims_iters.first, dims_iters.second);
+}
+  
 template <typename T>
 struct AllocateArray { 
   template <typename Iterator>
   JNoun::Ptr operator()(Dimensions result_dims, Iterator begin, Iterator end) const {
     assert(result_dims.get_rank() > 0);
     
-    shared_ptr<vector<T> > v(make_shared<vector<T> >(result_dims.number_of_elems(),
-						     JTypeTrait<T>::base_elem()));
+    typename JBuffer<T>::Ptr v(JBuffer<T>::InstantiateFilled(result_dims.number_of_elems(), JTypeTrait<T>::base_elem()));
     
-    typename vector<T>::iterator out_iter(v->begin());
+    typename JBuffer<T>::iterator out_iter(v->begin());
     
     int result_rank = result_dims.get_rank();
     Dimensions item_dim(result_dims.suffix(-1));
-    int elems_per_item(item_dim.number_of_elems());
+    JSize elems_per_item(item_dim.number_of_elems());
     
     for(;begin != end; ++begin) {
       JArray<T> arr(require_type<T>(**begin));
       if (arr.get_rank() == 0) {
-	fill_n(out_iter, elems_per_item, (*arr.begin()));
+	std::fill_n(out_iter, elems_per_item, (*arr.begin()));
 	out_iter += elems_per_item;
       } else if (arr.get_rank() == result_rank) {
-	int highest_dim = arr.get_dims()[0];
-	for (int i = 0; i < highest_dim; ++i) {
-	  static_cast<JArray<T>&> (*arr.coordinate(1, i)).extend_into(item_dim, out_iter);
+	JSize highest_dim = arr.get_dims()[0];
+	for (JSize i = 0; i < highest_dim; ++i) {
+	  static_cast<JArray<T>&> (*arr.coordinate(i)).extend_into(item_dim, out_iter);
 	  out_iter += elems_per_item;
 	}
 	
@@ -216,7 +216,7 @@ struct AllocateArray {
       }
     }
     
-    return static_pointer_cast<JNoun>(make_shared<JArray<T> >(result_dims, v));
+    return JNoun::Ptr(new JArray<T>(result_dims, v));
   }
 };
 
@@ -243,7 +243,7 @@ JNoun::Ptr concatenate_nouns(Iterator in_begin, Iterator in_end) {
     type = j_value_type_int;
   } 
   
-  int highest_coord = 0;
+  JSize highest_coord = 0;
 
   typedef get_dimensions<Iterator> get_dims;
   typename get_dims::result_type dims_iters(get_dims()(in_begin, in_end));
@@ -256,7 +256,7 @@ JNoun::Ptr concatenate_nouns(Iterator in_begin, Iterator in_end) {
     }
   };
   
-  shared_ptr<vector<int> > new_dims_vec(boost::make_shared<vector<int> >(dims.begin(), dims.end()));
+  shared_ptr<vector<JSize> > new_dims_vec(boost::make_shared<vector<JSize> >(dims.begin(), dims.end()));
   (*new_dims_vec)[0] = highest_coord;
   
   Dimensions new_dims(new_dims_vec);
@@ -1,73 +1,99 @@
 #include "Dimensions.hpp"
 
 namespace J {
-Dimensions::Dimensions(int rank, ...): dims(new vector<int>(rank)), 
-				       begin_iter(dims->begin()), end_iter(dims->end()),
-				       rank(rank) {
+Dimensions::Dimensions(int rank, ...): rank(0), nr_of_elems(1) {
+  allocate(rank);
+
   va_list va;
   va_start(va, rank);
-      
-  for (iter i = begin(); i != end(); ++i) {
+
+  for (JSize* i = storage(), *end = i + rank; i != end; ++i) {
     *i = va_arg(va, int);
   }
-      
+
   va_end(va);
+  compute_number_of_elems();
+}
+
+Dimensions::Dimensions(int rank, JSize extent): rank(0), nr_of_elems(1) {
+  assert(rank == 1);
+  allocate(rank);
+  *storage() = extent;
+  compute_number_of_elems();
+}
+
+Dimensions::Dimensions(): rank(0), nr_of_elems(1) {}
+
+Dimensions::Dimensions(shared_ptr<vector<JSize> > dims): rank(0), nr_of_elems(1) {
+  assign(dims->begin(), dims->end());
 }
 
-Dimensions::Dimensions(): dims(), begin_iter(0), 
-			  end_iter(0), rank(0) {}
+Dimensions::Dimensions(shared_ptr<vector<JSize> >, vector<JSize>::const_iterator begin,
+		       vector<JSize>::const_iterator end): rank(0), nr_of_elems(1) {
+  assign(begin, end);
+}
 
-Dimensions::Dimensions(shared_ptr<vector<int> > dims): dims(dims), begin_iter(dims->begin()), 
-						       end_iter(dims->end()), rank(dims->size()) {}
+Dimensions::Dimensions(const Dimensions& d): rank(0), nr_of_elems(1) {
+  assign(d.begin(), d.end());
+}
+
+Dimensions& Dimensions::operator=(const Dimensions& d) {
+  if (this != &d) {
+    assign(d.begin(), d.end());
+  }
+  return *this;
+}
+
+void Dimensions::allocate(int new_rank) {
+  assert(new_rank >= 0);
+  if (is_heap_allocated()) delete [] heap_dims;
+  rank = new_rank;
+  if (is_heap_allocated()) heap_dims = new JSize[new_rank];
+}
+
+void Dimensions::compute_number_of_elems() {
+  nr_of_elems = std::accumulate(begin(), end(), JSize(1), std::multiplies<JSize>());
+}
 
-Dimensions::Dimensions(shared_ptr<vector<int> > dims, iter begin, iter end): dims(dims), begin_iter(begin), 
-									     end_iter(end), 
-									     rank(distance(begin_iter, end_iter)) {}
-  
 bool Dimensions::operator==(const Dimensions& d) const {
-  return d.get_rank() == get_rank() && equal(begin(), end(), d.begin());
+  return d.get_rank() == get_rank() && std::equal(begin(), end(), d.begin());
 }
 
-      
-int Dimensions::operator[](int n) const {
-  if (n >= 0) { 
+
+JSize Dimensions::operator[](int n) const {
+  if (n >= 0) {
     assert(n < get_rank());
     return *(begin() + n);
   } else {
     assert(-n <= get_rank());
     return *(begin() + (get_rank() + n));
   }
-}    
-  
+}
+
 Dimensions Dimensions::suffix(int n) const {
   if (n >= get_rank()) return *this;
   if (-n >= get_rank()) return Dimensions();
-    
+
   const iter start = begin() + (n >= 0 ? (get_rank() - n) : -n);
-  return Dimensions(dims, start, end());
+  return from_range(start, end());
 }
-  
+
 Dimensions Dimensions::prefix(int n) const {
   if (n >= get_rank()) return *this;
   if (-n >= get_rank()) return Dimensions();
-    
+
   const iter stop = end() - (n >= 0 ? (get_rank() - n) : -n);
-  return Dimensions(dims, begin(), stop);
+  return from_range(begin(), stop);
 }
 
 bool Dimensions::prefix_match(const Dimensions &d) const {
-  return d.get_rank() <= get_rank() && equal(d.begin(), d.end(), begin());
+  return d.get_rank() <= get_rank() && std::equal(d.begin(), d.end(), begin());
 }
 
 bool Dimensions::suffix_match(const Dimensions &d) const {
-  return d.get_rank() <= get_rank() && equal(d.begin(), d.end(), begin() + (get_rank() - d.get_rank()));
-}
-
-int Dimensions::number_of_elems() const { 
-  return std::accumulate(begin(), end(), 1, std::multiplies<int>());
+  return d.get_rank() <= get_rank() && std::equal(d.begin(), d.end(), begin() + (get_rank() - d.get_rank()));
 }
 
-  
 string Dimensions::to_string() const {
   std::stringstream ss;
   ss << "J::Dimensions[ ";
@@ -80,24 +106,14 @@ string Dimensions::to_string() const {
 
 
 Dimensions Dimensions::operator+(const Dimensions &d) const {
-  shared_ptr<vector<int> > v(new vector<int>(d.get_rank() + get_rank()));
+  Dimensions res;
+  res.allocate(get_rank() + d.get_rank());
 
-  vector<int>::iterator output = v->begin();
-  iter ptr = begin();
+  JSize* output = std::copy(begin(), end(), res.storage());
+  std::copy(d.begin(), d.end(), output);
+  res.nr_of_elems = number_of_elems() * d.number_of_elems();
 
-  while (ptr != end()) {
-    *output = *ptr;
-    ++output;
-    ++ptr;
-  }
-  ptr = d.begin();
-  while (ptr != d.end()) {
-    *output = *ptr;
-    ++output;
-    ++ptr;
-  }
-    
-  return Dimensions(v);
+  return res;
 }
 
 std::ostream& operator<<(std::ostream& os, const Dimensions& d) {
@@ -7,7 +7,10 @@
 #include <string>
 #include <numeric>
 #include <sstream>
+#include <iterator>
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 
 namespace J {
 using std::vector;
@@ -15,44 +18,75 @@ using std::string;
 using boost::shared_ptr;
 using std::stringstream;
 
+typedef boost::int64_t JSize;
+
 class Dimensions {
-  typedef vector<int>::iterator iter;
+public:
+  typedef const JSize* iter;
+  static const int inline_rank = 2;
 
-  shared_ptr<vector<int> > dims;
-  iter begin_iter;
-  iter end_iter;
+private:
   int rank;
-    
+  JSize nr_of_elems;
+  union {
+    JSize inline_dims[inline_rank];
+    JSize* heap_dims;
+  };
+
+  bool is_heap_allocated() const { return rank > inline_rank; }
+  JSize* storage() { return is_heap_allocated() ? heap_dims : inline_dims; }
+  void allocate(int new_rank);
+  void compute_number_of_elems();
+
+  template <typename Iterator>
+  void assign(Iterator begin, Iterator end) {
+    allocate(std::distance(begin, end));
+    std::copy(begin, end, storage());
+    compute_number_of_elems();
+  }
+
 public:
   Dimensions(int rank, ...);
+  Dimensions(int rank, JSize extent);
 
   Dimensions();
 
-  Dimensions(shared_ptr<vector<int> > dims); 
-  Dimensions(shared_ptr<vector<int> > dims, iter begin, iter end);
-    
+  Dimensions(shared_ptr<vector<JSize> > dims);
+  Dimensions(shared_ptr<vector<JSize> > dims, vector<JSize>::const_iterator begin,
+	     vector<JSize>::const_iterator end);
+
+  Dimensions(const Dimensions& d);
+  Dimensions& operator=(const Dimensions& d);
+  ~Dimensions() { if (is_heap_allocated()) delete [] heap_dims; }
+
+  template <typename Iterator>
+  static Dimensions from_range(Iterator begin, Iterator end) {
+    Dimensions d;
+    d.assign(begin, end);
+    return d;
+  }
+
+  iter begin() const { return is_heap_allocated() ? heap_dims : inline_dims; }
+  iter end() const { return begin() + rank; }
 
-  iter begin() const { return begin_iter; }
-  iter end() const { return end_iter; }
-  
   int get_rank() const { return rank; }
   string to_string() const;
-    
-  bool operator!=(const Dimensions& d) const { 
-    return !(*this == d); 
+
+  bool operator!=(const Dimensions& d) const {
+    return !(*this == d);
   }
 
   bool operator==(const Dimensions& d) const;
-    
-  int operator[](int n) const; 
 
-  Dimensions suffix(int n) const; 
+  JSize operator[](int n) const;
+
+  Dimensions suffix(int n) const;
   Dimensions prefix(int n) const;
 
   bool prefix_match(const Dimensions &d) const;
   bool suffix_match(const Dimensions &d) const;
-    
-  int number_of_elems() const;
+
+  JSize number_of_elems() const { return nr_of_elems; }
 
   Dimensions operator+(const Dimensions &d) const;
 
@@ -18,7 +18,7 @@ bool is_gerund(JWord::Ptr word) {
     static_cast<JNoun&>(*word).get_value_type() == j_value_type_box &&
     static_cast<JNoun&>(*word).get_dims().number_of_elems() > 0 &&
     static_cast<JNoun&>(*word).get_rank() <= 1 &&
-    accumulate(static_cast<const JArray<JBox>&>(*word).begin(), static_cast<const JArray<JBox>&>(*word).end(),
+    std::accumulate(static_cast<const JArray<JBox>&>(*word).begin(), static_cast<const JArray<JBox>&>(*word).end(),
 	      true, is_verb_in_box());
 }
 }
@@ -6,7 +6,7 @@
 namespace J {
 class JAdverb: public JWord {
 public:
-  typedef shared_ptr<JAdverb> Ptr;
+  typedef JRef<JAdverb> Ptr;
 
   JAdverb(): JWord(grammar_class_adverb) {}
   virtual JWord::Ptr operator()(JMachine::Ptr m, JWord::Ptr word) const = 0;
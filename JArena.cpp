@@ -0,0 +1,110 @@
+#include "JArena.hpp"
+#include "JBuffer.hpp"
+#include "JBufferPool.hpp"
+#include <cstring>
+#include <cassert>
+
+namespace J {
+
+JBufferStorage::JBufferStorage(std::size_t bytes, bool relocatable):
+  data(0), bytes(bytes), arena(0), arena_slot(0), owner(), writable(true) {
+  allocate(relocatable);
+}
+
+JBufferStorage::JBufferStorage(void* data, std::size_t bytes, shared_ptr<void> owner, bool writable):
+  data(data), bytes(bytes), arena(0), arena_slot(0), owner(owner), writable(writable) {}
+
+JBufferStorage::~JBufferStorage() {
+  if (arena) {
+    arena->release(this);
+  } else if (!owner) {
+    JBufferPool::release(data, bytes);
+  }
+}
+
+void JBufferStorage::allocate(bool relocatable) {
+  JArena* candidate(JArena::get_active());
+  if (!relocatable || !candidate || !candidate->adopt(this)) {
+    data = JBufferPool::allocate(bytes);
+  }
+}
+
+void JBufferStorage::relocate() {
+  void* old_data(data);
+  arena = 0;
+  allocate(true);
+  std::memcpy(data, old_data, bytes);
+}
+
+__thread JArena* JArena::active = 0;
+
+JArena::JArena(): previous(active), chunks(), cursor(0), limit(0), live(), starts() {
+  active = this;
+}
+
+JArena::~JArena() {
+  assert(active == this);
+  active = previous;
+
+  for (vector<JBufferStorage*>::iterator i = live.begin(); i != live.end(); ++i) {
+    if (*i) (*i)->relocate();
+  }
+
+  for (vector<char*>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    JBufferPool::release(*i, chunk_size);
+  }
+}
+
+bool JArena::holds(const void* data) {
+  const char* address(static_cast<const char*>(data));
+  for (JArena* arena = active; arena; arena = arena->previous) {
+    for (vector<char*>::const_iterator i = arena->chunks.begin(); i != arena->chunks.end(); ++i) {
+      if (address >= *i && address < *i + chunk_size) return true;
+    }
+  }
+  return false;
+}
+
+bool JArena::new_chunk() {
+  if ((chunks.size() + 1) * chunk_size > max_sentence_bytes) return false;
+
+  char* chunk(static_cast<char*>(JBufferPool::allocate(chunk_size)));
+  chunks.push_back(chunk);
+  cursor = chunk;
+  limit = chunk + chunk_size;
+  return true;
+}
+
+bool JArena::adopt(JBufferStorage* storage) {
+  if (storage->bytes > max_allocation) return false;
+
+  std::size_t padding((buffer_alignment - reinterpret_cast<std::size_t>(cursor) % buffer_alignment) %
+		      buffer_alignment);
+  if (!cursor || static_cast<std::size_t>(limit - cursor) < padding + storage->bytes) {
+    if (!new_chunk()) return false;
+    padding = 0;
+  }
+
+  storage->data = cursor + padding;
+  storage->arena = this;
+  storage->arena_slot = live.size();
+  live.push_back(storage);
+  starts.push_back(cursor);
+  cursor += padding + storage->bytes;
+  return true;
+}
+
+void JArena::release(JBufferStorage* storage) {
+  assert(storage->arena == this && live[storage->arena_slot] == storage);
+  live[storage->arena_slot] = 0;
+
+  // The temporaries of a cell-wise loop die in the order they were made, so the space
+  // at the end of the current chunk is handed back to the cursor.
+  while (!live.empty() && !live.back() && starts.back() >= chunks.back() && starts.back() < limit) {
+    cursor = starts.back();
+    live.pop_back();
+    starts.pop_back();
+  }
+}
+
+}
@@ -0,0 +1,78 @@
+#ifndef JARENA_HPP
+#define JARENA_HPP
+
+#include <cstddef>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace J {
+using std::vector;
+using boost::shared_ptr;
+
+class JArena;
+
+class JBufferStorage {
+  friend class JArena;
+
+  void* data;
+  std::size_t bytes;
+  JArena* arena;
+  std::size_t arena_slot;
+  shared_ptr<void> owner;
+  bool writable;
+
+  JBufferStorage(const JBufferStorage&);
+  JBufferStorage& operator=(const JBufferStorage&);
+
+  void allocate(bool relocatable);
+  void relocate();
+
+protected:
+  JBufferStorage(std::size_t bytes, bool relocatable);
+  JBufferStorage(void* data, std::size_t bytes, shared_ptr<void> owner, bool writable);
+  ~JBufferStorage();
+
+  void* get_data() const { return data; }
+
+public:
+  bool is_arena_allocated() const { return arena != 0; }
+  bool is_external() const { return owner.get() != 0; }
+  bool is_writable() const { return !is_external() || writable; }
+};
+
+class JArena {
+  // Each thread evaluates its sentences in its own arena.
+  static __thread JArena* active;
+
+  JArena* previous;
+  vector<char*> chunks;
+  char* cursor;
+  char* limit;
+  vector<JBufferStorage*> live;
+  vector<char*> starts;
+
+  JArena(const JArena&);
+  JArena& operator=(const JArena&);
+
+  bool new_chunk();
+
+public:
+  static const std::size_t chunk_size = 64 * 1024;
+  static const std::size_t max_allocation = 16 * 1024;
+  // Past this a sentence's buffers come from the pool, which reuses them as they are freed.
+  static const std::size_t max_sentence_bytes = 1024 * 1024;
+
+  JArena();
+  ~JArena();
+
+  static JArena* get_active() { return active; }
+  // True when data lies in a chunk of this thread's arenas, which move it when they close.
+  static bool holds(const void* data);
+
+  bool adopt(JBufferStorage* storage);
+  void release(JBufferStorage* storage);
+};
+
+}
+
+#endif
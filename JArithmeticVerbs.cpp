@@ -1,4 +1,5 @@
 #include "JArithmeticVerbs.hpp"
+#include "JRagged.hpp"
 
 namespace J {
 template <typename T>
@@ -6,28 +7,348 @@ JArithmeticVerb<T>::JArithmeticVerb(shared_ptr<Monad> monad, shared_ptr<Dyad> dy
   JVerb(monad, dyad), unit_value(unit_value) {}
   
 template <typename T>
-shared_ptr<JNoun> JArithmeticVerb<T>::unit(const Dimensions& dims) const {
+JNoun::Ptr JArithmeticVerb<T>::unit(const Dimensions& dims) const {
   return filled_array(dims, unit_value);
 }
 
 template class JArithmeticVerb<JInt>;
 
-JNoun::Ptr IDotVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& noun) const { 
-  const JArray<JInt>& arg = require_type<JInt>(noun);
-  vector<int> v(arg.begin(), arg.end());
-  int new_size(std::abs(accumulate(v.begin(), v.end(), 1, std::multiplies<int>())));
-  shared_ptr<vector<JInt> > res(new vector<JInt>(new_size));
+template <typename Result>
+JNoun::Ptr sum_result(JInt64 total) {
+  if (total < std::numeric_limits<Result>::min() || total > std::numeric_limits<Result>::max()) {
+    return scalar_noun(static_cast<JFloat>(total));
+  }
+  return scalar_noun(static_cast<Result>(total));
+}
+
+template <typename T, typename Result>
+JNoun::Ptr checked_sum(const JArray<T>& arg) {
+  const T* values(arg.begin());
+  JSize n(arg.get_dims().number_of_elems());
+  JInt64 total(0);
+
+  for (JSize done = 0; done < n; done += checked_block_size) {
+    JSize len(std::min<JSize>(checked_block_size, n - done));
+    JInt64 block_total(total), overflow(0);
+    for (JSize i = 0; i < len; ++i) {
+      block_total = CheckedAdd::apply(block_total, static_cast<JInt64>(values[done + i]), overflow);
+    }
+
+    if (overflow < 0) {
+      JFloat float_total(static_cast<JFloat>(total));
+      for (JSize i = done; i < n; ++i) {
+	float_total += values[i];
+      }
+      return scalar_noun(float_total);
+    }
+    total = block_total;
+  }
+
+  return sum_result<Result>(total);
+}
+
+template <typename Result>
+JNoun::Ptr progression_sum(const JProgression& p, JSize n) {
+  JInt64 overflow(0);
+  JInt64 triangle(n % 2 == 0 ? 
+		  CheckedMultiply::apply(n / 2, n - 1, overflow) : 
+		  CheckedMultiply::apply(n, (n - 1) / 2, overflow));
+  JInt64 total(CheckedAdd::apply(CheckedMultiply::apply(n, p.start, overflow), 
+				 CheckedMultiply::apply(p.step, triangle, overflow), overflow));
+
+  if (overflow < 0) {
+    JFloat float_total(static_cast<JFloat>(n) * p.start + 
+		       static_cast<JFloat>(p.step) * (static_cast<JFloat>(n) * (n - 1) / 2));
+    return scalar_noun(float_total);
+  }
+  return sum_result<Result>(total);
+}
+
+JNoun::Ptr PlusVerb::reduce(JMachine::Ptr, const JNoun& arg) const {
+  if (arg.get_rank() != 1) {
+    return reduce_items(simd_op_add, arg);
+  }
+
+  optional<JProgression> progression(arg.get_progression());
+  if (progression) {
+    JSize n(arg.get_dims().number_of_elems());
+    if (arg.get_value_type() == j_value_type_float) {
+      return scalar_noun(static_cast<JFloat>(n) * progression->start + 
+			 static_cast<JFloat>(progression->step) * (static_cast<JFloat>(n) * (n - 1) / 2));
+    }
+    return arg.get_value_type() == j_value_type_int64 ? 
+      progression_sum<JInt64>(*progression, n) : 
+      progression_sum<JInt>(*progression, n);
+  }
+
+  if (arg.get_value_type() == j_value_type_bool) {
+    const JArray<JBool>& bits(static_cast<const JArray<JBool>&>(arg));
+    return scalar_noun(static_cast<JInt>(count_bits(bits.begin(), bits.end())));
+  }
+
+  JNoun::Ptr reduced(reduce_items(simd_op_add, arg));
+  if (reduced) return reduced;
+
+  switch (arg.get_value_type()) {
+  case j_value_type_int8:
+    return checked_sum<JInt8, JInt>(static_cast<const JArray<JInt8>&>(arg));
+  case j_value_type_int16:
+    return checked_sum<JInt16, JInt>(static_cast<const JArray<JInt16>&>(arg));
+  case j_value_type_int:
+    return checked_sum<JInt, JInt>(static_cast<const JArray<JInt>&>(arg));
+  case j_value_type_int64:
+    return checked_sum<JInt64, JInt64>(static_cast<const JArray<JInt64>&>(arg));
+  default:
+    return JNoun::Ptr();
+  }
+}
+
+JNoun::Ptr SignumTimesVerb::reduce(JMachine::Ptr, const JNoun& arg) const {
+  return reduce_items(simd_op_multiply, arg);
+}
+
+JNoun::Ptr FloorLesserofVerb::reduce(JMachine::Ptr, const JNoun& arg) const {
+  return reduce_items(simd_op_lesser, arg);
+}
+
+JNoun::Ptr CeilingGreaterofVerb::reduce(JMachine::Ptr, const JNoun& arg) const {
+  return reduce_items(simd_op_greater, arg);
+}
+
+JNoun::Ptr PlusVerb::reduce_cells(JMachine::Ptr, const JNoun& arg, int rank) const {
+  return J::reduce_cells(simd_op_add, arg, rank);
+}
+
+JNoun::Ptr SignumTimesVerb::reduce_cells(JMachine::Ptr, const JNoun& arg, int rank) const {
+  return J::reduce_cells(simd_op_multiply, arg, rank);
+}
+
+JNoun::Ptr FloorLesserofVerb::reduce_cells(JMachine::Ptr, const JNoun& arg, int rank) const {
+  return J::reduce_cells(simd_op_lesser, arg, rank);
+}
+
+JNoun::Ptr CeilingGreaterofVerb::reduce_cells(JMachine::Ptr, const JNoun& arg, int rank) const {
+  return J::reduce_cells(simd_op_greater, arg, rank);
+}
+
+JFloat float_gcd(JFloat a, JFloat b) {
+  a = std::abs(a);
+  b = std::abs(b);
+  // Remainders this small are left over from rounding in the divisions before them.
+  JFloat tolerance(std::max(a, b) * 1e-13);
+  while (b > tolerance) {
+    JFloat t(std::fmod(a, b));
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+JComplex complex_gcd(JComplex a, JComplex b) {
+  JFloat tolerance(std::max(std::abs(a), std::abs(b)) * 1e-13);
+  while (std::abs(b) > tolerance) {
+    JComplex q(a / b);
+    JComplex t(a - JComplex(std::floor(q.real() + 0.5), std::floor(q.imag() + 0.5)) * b);
+    a = b;
+    b = t;
+  }
+  // Of the four associates, the one in the first quadrant.
+  for (int i = 0; i < 4 && !(a.real() > 0 && a.imag() >= 0); ++i) {
+    a *= JComplex(0, 1);
+  }
+  return a;
+}
+
+namespace GcdOrVerbNS {
+
+template <typename T>
+struct RealImagParts {
+  JNoun::Ptr operator()(const JArray<T>& arg) const {
+    intrusive_ptr<JArray<T> > res(filled_array<T>(arg.get_dims() + Dimensions(1, 2), 
+						   JTypeTrait<T>::base_elem()));
+    typename JArray<T>::iter out(res->begin());
+    for (typename JArray<T>::iter i(arg.begin()), e(arg.end()); i != e; ++i, out += 2) {
+      *out = *i;
+    }
+    return res;
+  }
+};
+
+template <>
+struct RealImagParts<JComplex> {
+  JNoun::Ptr operator()(const JArray<JComplex>& arg) const {
+    intrusive_ptr<JArray<JFloat> > res(allocated_array<JFloat>(arg.get_dims() + Dimensions(1, 2)));
+    JArray<JFloat>::iter out(res->begin());
+    for (JArray<JComplex>::iter i(arg.begin()), e(arg.end()); i != e; ++i, out += 2) {
+      out[0] = i->real();
+      out[1] = i->imag();
+    }
+    return res;
+  }
+};
+
+template <>
+struct RealImagParts<JBox> {
+  JNoun::Ptr operator()(const JArray<JBox>&) const { throw JIllegalValueTypeException(); }
+};
+
+template <>
+struct RealImagParts<JChar> {
+  JNoun::Ptr operator()(const JArray<JChar>&) const { throw JIllegalValueTypeException(); }
+};
+
+JNoun::Ptr RealImagMonadOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  return JArrayCaller<RealImagParts, JNoun::Ptr>()(arg);
+}
+
+}
+
+namespace LcmAndVerbNS {
+
+template <typename T>
+JComplex as_complex(T value) {
+  return JComplex(static_cast<JFloat>(value), 0);
+}
+
+inline JComplex as_complex(JComplex value) {
+  return value;
+}
+
+template <typename T>
+struct LengthAngleParts {
+  JNoun::Ptr operator()(const JArray<T>& arg) const {
+    intrusive_ptr<JArray<JFloat> > res(allocated_array<JFloat>(arg.get_dims() + Dimensions(1, 2)));
+    JArray<JFloat>::iter out(res->begin());
+    for (typename JArray<T>::iter i(arg.begin()), e(arg.end()); i != e; ++i, out += 2) {
+      JComplex value(as_complex(static_cast<T>(*i)));
+      out[0] = std::abs(value);
+      out[1] = std::arg(value);
+    }
+    return res;
+  }
+};
+
+template <>
+struct LengthAngleParts<JBox> {
+  JNoun::Ptr operator()(const JArray<JBox>&) const { throw JIllegalValueTypeException(); }
+};
+
+template <>
+struct LengthAngleParts<JChar> {
+  JNoun::Ptr operator()(const JArray<JChar>&) const { throw JIllegalValueTypeException(); }
+};
+
+JNoun::Ptr LengthAngleMonadOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  return JArrayCaller<LengthAngleParts, JNoun::Ptr>()(arg);
+}
+
+}
+
+namespace NotVerbNS {
+
+JNoun::Ptr NotMonad::operator()(JMachine::Ptr m, const JNoun& arg) const {
+  if (arg.get_value_type() == j_value_type_bool) return (*flip)(m, arg);
+  return (*minus)(m, JArray<JInt>(Dimensions(0), 1), arg);
+}
+
+JNoun::Ptr NotMonad::apply_owned(JMachine::Ptr m, const JNoun::Ptr& arg) const {
+  if (arg->get_value_type() == j_value_type_bool) return flip->apply_owned(m, arg);
+  return minus->apply_owned(m, JNoun::Ptr(new JArray<JInt>(Dimensions(0), 1)), arg);
+}
+
+template <typename T>
+struct KeptItems {
+  JNoun::Ptr operator()(const JArray<T>& items, const vector<bool>& keep) const {
+    Dimensions item(items.get_dims().suffix(-1));
+    JSize item_size(item.number_of_elems());
+    shared_ptr<vector<T> > kept(new vector<T>());
+    typename JArray<T>::iter source(items.begin());
+    for (std::size_t i = 0; i < keep.size(); ++i, source += item_size) {
+      if (keep[i]) kept->insert(kept->end(), source, source + item_size);
+    }
+    return JNoun::Ptr(new JArray<T>(Dimensions(1, kept->size() / item_size) + item, kept));
+  }
+};
+
+template <typename T>
+struct MarkFoundItems {
+  bool operator()(const JArray<T>& items, const JArray<T>& cells, vector<bool>* keep) const {
+    JSize item_size(items.get_dims().suffix(-1).number_of_elems());
+    bool found(false);
+    typename JArray<T>::iter item(items.begin()), cells_begin(cells.begin()), cells_end(cells.end());
+    for (std::size_t i = 0; i < keep->size(); ++i, item += item_size) {
+      for (typename JArray<T>::iter cell(cells_begin); cell != cells_end; cell += item_size) {
+	if (std::equal(item, item + item_size, cell)) {
+	  (*keep)[i] = false;
+	  found = true;
+	  break;
+	}
+      }
+    }
+    return found;
+  }
+};
+
+JNoun::Ptr LessDyadOp::operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const {
+  JNoun::Ptr items(larg.view(larg.is_scalar() ? Dimensions(1, 1) : larg.get_dims(), 0));
+  Dimensions item(items->get_dims().suffix(-1));
+  JSize item_size(item.number_of_elems());
+  if (item_size == 0 || !rarg.get_dims().suffix_match(item) ||
+      !TypeConversions::get_instance()->find_best_type_conversion(larg.get_value_type(), 
+								   rarg.get_value_type())) {
+    return items;
+  }
+
+  JNoun::Ptr cells(rarg.view(Dimensions(1, rarg.get_dims().number_of_elems() / item_size) + item, 0));
+  vector<bool> keep(items->get_dims()[0], true);
+  if (!CallWithCommonType<MarkFoundItems, bool>()(*items, *cells, &keep)) return items;
+  return JArrayCaller<KeptItems, JNoun::Ptr>()(*items, keep);
+}
+
+}
+
+template <typename T>
+JNoun::Ptr counted_array(const vector<JSize>& v, const Dimensions& dims) {
+  typename JBuffer<T>::Ptr res(JBuffer<T>::Instantiate(dims.number_of_elems()));
   
-  typename vector<JInt>::iterator iter(res->begin()), end(res->end());
+  typename JBuffer<T>::iterator iter(res->begin()), end(res->end());
   
   for(DimensionCounter dc(v); iter != end; ++dc, ++iter) {
-    *iter = *dc;
+    *iter = static_cast<T>(*dc);
   }
   
-  shared_ptr<vector<int> > dims_vec(new vector<int>(v.size()));
-  transform(v.begin(), v.end(), dims_vec->begin(), std::ptr_fun<JInt, JInt>(std::abs));
+  return JNoun::Ptr(new JArray<T>(dims, res));
+}
+
+JNoun::Ptr IDotVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& noun) const { 
+  const JArray<JInt64>& arg = require_type<JInt64>(noun);
+  vector<JSize> v(arg.begin(), arg.end());
   
-  return JNoun::Ptr(new JArray<JInt>(Dimensions(dims_vec), res));
+  shared_ptr<vector<JSize> > dims_vec(new vector<JSize>(v.size()));
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    (*dims_vec)[i] = v[i] < 0 ? -v[i] : v[i];
+  }
+  Dimensions dims(dims_vec);
+  j_value_type type(narrowest_int_type(0, dims.number_of_elems() - 1));
+
+  bool ascending(std::find_if(v.begin(), v.end(), boost::bind(std::less<JSize>(), _1, 0)) == v.end());
+  bool descending(std::find_if(v.begin(), v.end(), boost::bind(std::greater_equal<JSize>(), _1, 0)) == v.end());
+  if (ascending) {
+    return progression_array(dims, JProgression(0, 1), type);
+  } else if (descending) {
+    return progression_array(dims, JProgression(dims.number_of_elems() - 1, -1), type);
+  }
+
+  switch (type) {
+  case j_value_type_int8:
+    return counted_array<JInt8>(v, dims);
+  case j_value_type_int16:
+    return counted_array<JInt16>(v, dims);
+  case j_value_type_int:
+    return counted_array<JInt>(v, dims);
+  default:
+    return counted_array<JInt64>(v, dims);
+  }
 }
   
 JNoun::Ptr IDotVerb::DyadOp::operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
@@ -41,7 +362,8 @@ JNoun::Ptr IDotVerb::DyadOp::operator()(JMachine::Ptr m, const JNoun& larg, cons
   if (!TypeConversions::get_instance()
       ->find_best_type_conversion(larg.get_value_type(), rarg.get_value_type()) ||
       !rarg.get_dims().suffix_match(haystack_dims)) {
-    shared_ptr<vector<JInt> > v(new vector<JInt>(frame.number_of_elems(), larg.is_scalar() ? 1 : larg.get_dims()[0]));
+    JBuffer<JInt>::Ptr v(JBuffer<JInt>::InstantiateFilled(frame.number_of_elems(), 
+							   larg.is_scalar() ? 1 : larg.get_dims()[0]));
     return JNoun::Ptr(new JArray<JInt>(frame, v));
   }
   
@@ -52,18 +374,18 @@ template <typename T>
 JNoun::Ptr IDotDyadOp<T>::operator()(const JArray<T>& larg, const JArray<T>& rarg, JMachine::Ptr,
 				     const Dimensions& haystack_dims, const Dimensions& frame) const { 
 
-  shared_ptr<vector<JInt> > res(new vector<JInt>(frame.number_of_elems()));
-  int increment = haystack_dims.number_of_elems();
+  JBuffer<JInt>::Ptr res(JBuffer<JInt>::Instantiate(frame.number_of_elems()));
+  JSize increment = haystack_dims.number_of_elems();
 
-  vector<JInt>::iterator output(res->begin());
-  typename vector<T>::iterator needle_iter(rarg.begin()), needle_end(rarg.end());
+  JBuffer<JInt>::iterator output(res->begin());
+  typename JArray<T>::iter needle_iter(rarg.begin()), needle_end(rarg.end());
   
-  for(;needle_iter != needle_end; advance(needle_iter, increment), ++output) {
-    typename vector<T>::iterator haystack_iter(larg.begin()), haystack_end(larg.end());
+  for(;needle_iter != needle_end; std::advance(needle_iter, increment), ++output) {
+    typename JArray<T>::iter haystack_iter(larg.begin()), haystack_end(larg.end());
 
     JInt i = 0;
-    for(; haystack_iter != haystack_end; ++i, advance(haystack_iter, increment)) {
-      if (equal(haystack_iter, haystack_iter + increment, needle_iter)) break;
+    for(; haystack_iter != haystack_end; ++i, std::advance(haystack_iter, increment)) {
+      if (std::equal(haystack_iter, haystack_iter + increment, needle_iter)) break;
     }
     *output = i;
   }
@@ -72,7 +394,7 @@ JNoun::Ptr IDotDyadOp<T>::operator()(const JArray<T>& larg, const JArray<T>& rar
 }
 
 JNoun::Ptr LessBoxVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& noun) const { 
-  shared_ptr<vector<JBox> > v(new vector<JBox>(1, JBox(noun.clone())));
+  JBuffer<JBox>::Ptr v(JBuffer<JBox>::InstantiateFilled(1, JBox(noun.clone())));
   return JNoun::Ptr(new JArray<JBox>(Dimensions(0), v));
 }
 
@@ -84,4 +406,12 @@ JNoun::Ptr MoreUnboxVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& noun)
   return boost::static_pointer_cast<JNoun>(arg.get_scalar_value().get_contents());
 }
 
+JNoun::Ptr MoreUnboxVerb::OpenMonad::operator()(JMachine::Ptr m, const JNoun& arg) const {
+  if (arg.get_value_type() == j_value_type_box) {
+    JNoun::Ptr flat(flat_open(static_cast<const JArray<JBox>&>(arg)));
+    if (flat) return flat;
+  }
+  return monadic_apply(0, m, arg, MonadOp());
+}
+
 }
@@ -5,11 +5,13 @@
 #include "JExceptions.hpp"
 #include "VerbHelpers.hpp"
 #include "JMachine.hpp"
+#include "JReductions.hpp"
 #include <functional>
 #include <numeric>
 #include <functional>
 #include <map>
 #include <boost/optional.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 #include <cmath>
 
 namespace J {
@@ -21,7 +23,7 @@ class JArithmeticVerb: public JVerb {
     
 public:
   JArithmeticVerb(shared_ptr<Monad> monad, shared_ptr<Dyad> dyad, T unit_value);
-  shared_ptr<JNoun> unit(const Dimensions& dims) const;
+  JNoun::Ptr unit(const Dimensions& dims) const;
 };
 
 template <typename Arg>
@@ -57,11 +59,44 @@ struct PlusDyadOp<JBox>: BadScalarDyadOp<JBox> {};
 template <>
 struct PlusDyadOp<JChar>: BadScalarDyadOp<JChar> {};
 
+template <>
+struct PlusDyadOp<JInt>: OverflowCheckedDyadOp<JInt, CheckedAdd> {};
+
+template <>
+struct PlusDyadOp<JInt64>: OverflowCheckedDyadOp<JInt64, CheckedAdd> {};
+
+template <>
+struct PlusDyadOp<JBool>: PromotedScalarDyadOp<PlusDyadOp> {};
+
+template <typename Arg>
+struct SimdOpTrait<PlusDyadOp<Arg> > {
+  static const simd_op value = simd_op_add;
+};
+
+template <>
+struct ProgressionRule<PlusDyadOp> {
+  static bool with_scalar(const JProgression& p, JInt64 scalar, bool, JProgression* res) {
+    JInt64 overflow(0);
+    *res = JProgression(CheckedAdd::apply(p.start, scalar, overflow), p.step);
+    return overflow >= 0;
+  }
+
+  static bool with_progression(const JProgression& p1, const JProgression& p2, JProgression* res) {
+    JInt64 overflow(0);
+    *res = JProgression(CheckedAdd::apply(p1.start, p2.start, overflow), 
+			CheckedAdd::apply(p1.step, p2.step, overflow));
+    return overflow >= 0;
+  }
+};
+
 class PlusVerb: public JArithmeticVerb<JInt> { 
 public:
   PlusVerb(): 
     JArithmeticVerb(ScalarMonad<PlusMonadOp>::Instantiate(),
 		    ScalarDyad<PlusDyadOp>::Instantiate(), 0) {}
+
+  JNoun::Ptr reduce(JMachine::Ptr m, const JNoun& arg) const;
+  JNoun::Ptr reduce_cells(JMachine::Ptr m, const JNoun& arg, int rank) const;
 };
 
 namespace SignumTimesVerbNS {
@@ -86,6 +121,9 @@ struct SignumMonadOp<JBox>: BadScalarMonadOp<JBox> {};
 template <> 
 struct SignumMonadOp<JChar>: BadScalarMonadOp<JChar> {};
 
+template <>
+struct SignumMonadOp<JBool>: PromotedScalarMonadOp<SignumMonadOp> {};
+
 template <typename Arg>
 struct TimesDyadOp: public std::binary_function<Arg, Arg, Arg> {
   Arg operator()(Arg arg1, Arg arg2) const {
@@ -99,14 +137,45 @@ struct TimesDyadOp<JBox>: BadScalarDyadOp<JBox> {};
 template <>
 struct TimesDyadOp<JChar>: BadScalarDyadOp<JChar> {};
 
+template <>
+struct TimesDyadOp<JBool>: BitwiseDyadOp<BitAnd> {};
+
+template <>
+struct TimesDyadOp<JInt>: OverflowCheckedDyadOp<JInt, CheckedMultiply> {};
+
+template <>
+struct TimesDyadOp<JInt64>: OverflowCheckedDyadOp<JInt64, CheckedMultiply> {};
+
 }
 
+template <typename Arg>
+struct SimdOpTrait<SignumTimesVerbNS::TimesDyadOp<Arg> > {
+  static const simd_op value = simd_op_multiply;
+};
+
+template <>
+struct ProgressionRule<SignumTimesVerbNS::TimesDyadOp> {
+  static bool with_scalar(const JProgression& p, JInt64 scalar, bool, JProgression* res) {
+    JInt64 overflow(0);
+    *res = JProgression(CheckedMultiply::apply(p.start, scalar, overflow), 
+			CheckedMultiply::apply(p.step, scalar, overflow));
+    return overflow >= 0;
+  }
+
+  static bool with_progression(const JProgression&, const JProgression&, JProgression*) { 
+    return false; 
+  }
+};
+
 
 class SignumTimesVerb: public JArithmeticVerb<JInt> {
 public:
   SignumTimesVerb(): 
     JArithmeticVerb(ScalarMonad<SignumTimesVerbNS::SignumMonadOp>::Instantiate(),
 		    ScalarDyad<SignumTimesVerbNS::TimesDyadOp>::Instantiate(), 1) {}
+
+  JNoun::Ptr reduce(JMachine::Ptr m, const JNoun& arg) const;
+  JNoun::Ptr reduce_cells(JMachine::Ptr m, const JNoun& arg, int rank) const;
 };
 
 namespace ReciprocalDivideVerbNS {
@@ -152,6 +221,11 @@ struct DivideDyadOp<JChar>: public BadScalarDyadOp<JChar> {};
 
 }
 
+template <typename Arg>
+struct SimdOpTrait<ReciprocalDivideVerbNS::DivideDyadOp<Arg> > {
+  static const simd_op value = simd_op_divide;
+};
+
 class ReciprocalDivideVerb: public JArithmeticVerb<JInt> {
 public:
   ReciprocalDivideVerb(): 
@@ -177,6 +251,13 @@ struct FloorMonadOp<JInt>: public std::unary_function<JInt, JInt> {
   }
 };
 
+template <> 
+struct FloorMonadOp<JBool>: public std::unary_function<JBool, JBool> {
+  JBool operator()(JBool arg) const {
+    return arg;
+  }
+};
+
 template <>
 struct FloorMonadOp<JFloat>: public std::unary_function<JFloat, JInt> {
   JInt operator()(JFloat arg) const {
@@ -200,13 +281,24 @@ struct LesserofDyadOp<JComplex>: public BadScalarDyadOp<JComplex> {};
 template <>
 struct LesserofDyadOp<JChar>: public BadScalarDyadOp<JChar> {};
 
+template <>
+struct LesserofDyadOp<JBool>: public BitwiseDyadOp<BitAnd> {};
+
 }
+
+template <typename Arg>
+struct SimdOpTrait<FloorLesserofVerbNS::LesserofDyadOp<Arg> > {
+  static const simd_op value = simd_op_lesser;
+};
   
 class FloorLesserofVerb: public JArithmeticVerb<JInt> {
 public:
   FloorLesserofVerb(): 
     JArithmeticVerb<JInt>(ScalarMonad<FloorLesserofVerbNS::FloorMonadOp>::Instantiate(),
 			  ScalarDyad<FloorLesserofVerbNS::LesserofDyadOp>::Instantiate(), 0) {}
+
+  JNoun::Ptr reduce(JMachine::Ptr m, const JNoun& arg) const;
+  JNoun::Ptr reduce_cells(JMachine::Ptr m, const JNoun& arg, int rank) const;
 };
 
 namespace CeilingGreaterofVerbNS {
@@ -220,6 +312,13 @@ struct CeilingMonadOp<JInt>: public std::unary_function<JInt, JInt> {
   }
 };
 
+template <> 
+struct CeilingMonadOp<JBool>: public std::unary_function<JBool, JBool> {
+  JBool operator()(JBool arg) const {
+    return arg;
+  }
+};
+
 template <>
 struct CeilingMonadOp<JFloat>: public std::unary_function<JFloat, JInt> {
   JInt operator()(JFloat arg) const {
@@ -243,18 +342,32 @@ struct GreaterofDyadOp<JComplex>: public BadScalarDyadOp<JComplex> {};
 template <>
 struct GreaterofDyadOp<JChar>: public BadScalarDyadOp<JChar> {};
 
+template <>
+struct GreaterofDyadOp<JBool>: public BitwiseDyadOp<BitOr> {};
+
 }
+
+template <typename Arg>
+struct SimdOpTrait<CeilingGreaterofVerbNS::GreaterofDyadOp<Arg> > {
+  static const simd_op value = simd_op_greater;
+};
   
 class CeilingGreaterofVerb: public JArithmeticVerb<JInt> {
 public:
   CeilingGreaterofVerb(): 
     JArithmeticVerb<JInt>(ScalarMonad<CeilingGreaterofVerbNS::CeilingMonadOp>::Instantiate(),
 			  ScalarDyad<CeilingGreaterofVerbNS::GreaterofDyadOp>::Instantiate(), 0) {}
+
+  JNoun::Ptr reduce(JMachine::Ptr m, const JNoun& arg) const;
+  JNoun::Ptr reduce_cells(JMachine::Ptr m, const JNoun& arg, int rank) const;
 };
 
 template <>
 struct MinusMonadOp<JBox>: public BadScalarMonadOp<JBox> {};
 
+template <>
+struct MinusMonadOp<JBool>: public PromotedScalarMonadOp<MinusMonadOp> {};
+
 template <typename Arg>
 struct MinusDyadOp: std::binary_function<Arg, Arg, Arg> {
   Arg operator()(Arg larg, Arg rarg) const {
@@ -265,6 +378,41 @@ struct MinusDyadOp: std::binary_function<Arg, Arg, Arg> {
 template <>
 struct MinusDyadOp<JBox>: public BadScalarDyadOp<JBox> {};
 
+template <>
+struct MinusDyadOp<JInt>: public OverflowCheckedDyadOp<JInt, CheckedSubtract> {};
+
+template <>
+struct MinusDyadOp<JInt64>: public OverflowCheckedDyadOp<JInt64, CheckedSubtract> {};
+
+template <>
+struct MinusDyadOp<JBool>: public PromotedScalarDyadOp<MinusDyadOp> {};
+
+template <typename Arg>
+struct SimdOpTrait<MinusDyadOp<Arg> > {
+  static const simd_op value = simd_op_subtract;
+};
+
+template <>
+struct ProgressionRule<MinusDyadOp> {
+  static bool with_scalar(const JProgression& p, JInt64 scalar, bool scalar_left, JProgression* res) {
+    JInt64 overflow(0);
+    if (scalar_left) {
+      *res = JProgression(CheckedSubtract::apply(scalar, p.start, overflow), 
+			  CheckedSubtract::apply(JInt64(0), p.step, overflow));
+    } else {
+      *res = JProgression(CheckedSubtract::apply(p.start, scalar, overflow), p.step);
+    }
+    return overflow >= 0;
+  }
+
+  static bool with_progression(const JProgression& p1, const JProgression& p2, JProgression* res) {
+    JInt64 overflow(0);
+    *res = JProgression(CheckedSubtract::apply(p1.start, p2.start, overflow), 
+			CheckedSubtract::apply(p1.step, p2.step, overflow));
+    return overflow >= 0;
+  }
+};
+
 class MinusVerb: public JArithmeticVerb<JInt> { 
 public:
   MinusVerb(): JArithmeticVerb(ScalarMonad<MinusMonadOp>::Instantiate(),
@@ -296,12 +444,15 @@ public:
 namespace LessBoxVerbNS {
 
 template <typename T>
-struct DyadOp: public std::binary_function<T, T, JInt> { 
-  JInt operator()(const T& arg1, const T& arg2) const  {
+struct DyadOp: public std::binary_function<T, T, JBool> { 
+  JBool operator()(const T& arg1, const T& arg2) const  {
     return arg1 < arg2;
   }
 };
 
+template <>
+struct DyadOp<JBool>: public BitwiseDyadOp<BitLess> {};
+
 template <>
 struct DyadOp<JBox>: public BadScalarDyadOp<JBox> {};
 
@@ -327,12 +478,15 @@ public:
 namespace MoreUnboxVerbNS {
 
 template <typename T>
-struct DyadOp: public std::binary_function<T, T, JInt> {
-  JInt operator()(const T& arg1, const T& arg2) const { 
+struct DyadOp: public std::binary_function<T, T, JBool> {
+  JBool operator()(const T& arg1, const T& arg2) const { 
     return arg1 > arg2;
   }
 };
 
+template <>
+struct DyadOp<JBool>: public BitwiseDyadOp<BitMore> {};
+
 template <> 
 struct DyadOp<JComplex> : public BadScalarDyadOp<JComplex> {};
 
@@ -349,8 +503,14 @@ class MoreUnboxVerb: public JVerb {
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& noun) const;
   };
 
+  class OpenMonad: public Monad {
+  public:
+    OpenMonad(): Monad(0) {}
+    JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const;
+  };
+
 public:  
-  MoreUnboxVerb(): JVerb(DefaultMonad<MonadOp>::Instantiate(0, MonadOp()),
+  MoreUnboxVerb(): JVerb(Monad::Ptr(new OpenMonad()),
 			 ScalarDyad<J::MoreUnboxVerbNS::DyadOp>::Instantiate()) {}
 };
 
@@ -375,13 +535,19 @@ struct DecrementMonadOp<JBox>: BadScalarMonadOp<JBox> {};
 template <>
 struct DecrementMonadOp<JChar>: BadScalarMonadOp<JChar> {};
 
+template <>
+struct DecrementMonadOp<JBool>: PromotedScalarMonadOp<DecrementMonadOp> {};
+
 template <typename Arg>
-struct LessequalDyadOp: public std::binary_function<Arg, Arg, JInt> {
-  JInt operator()(Arg arg1, Arg arg2) const { 
-    return arg1 <= arg2 ? 1 : 0;
+struct LessequalDyadOp: public std::binary_function<Arg, Arg, JBool> {
+  JBool operator()(Arg arg1, Arg arg2) const { 
+    return arg1 <= arg2;
   }
 };
 
+template <>
+struct LessequalDyadOp<JBool>: BitwiseDyadOp<BitLessequal> {};
+
 template <>
 struct LessequalDyadOp<JBox>: BadScalarDyadOp<JBox> {};
 
@@ -392,6 +558,11 @@ template <>
 struct LessequalDyadOp<JChar>: BadScalarDyadOp<JChar> {};
 }
 
+template <typename Arg>
+struct SimdOpTrait<DecrementLessequalVerbNS::LessequalDyadOp<Arg> > {
+  static const simd_op value = simd_op_lessequal;
+};
+
 class DecrementLessequalVerb: public JArithmeticVerb<JInt> {
 public:
   DecrementLessequalVerb():
@@ -421,13 +592,19 @@ struct IncrementMonadOp<JBox>: BadScalarMonadOp<JBox> {};
 template <>
 struct IncrementMonadOp<JChar>: BadScalarMonadOp<JChar> {};
 
+template <>
+struct IncrementMonadOp<JBool>: PromotedScalarMonadOp<IncrementMonadOp> {};
+
 template <typename Arg>
-struct MoreequalDyadOp: public std::binary_function<Arg, Arg, JInt> {
-  JInt operator()(Arg arg1, Arg arg2) const { 
-    return arg1 >= arg2 ? 1 : 0;
+struct MoreequalDyadOp: public std::binary_function<Arg, Arg, JBool> {
+  JBool operator()(Arg arg1, Arg arg2) const { 
+    return arg1 >= arg2;
   }
 };
 
+template <>
+struct MoreequalDyadOp<JBool>: BitwiseDyadOp<BitMoreequal> {};
+
 template <>
 struct MoreequalDyadOp<JComplex>: BadScalarDyadOp<JComplex> {};
 
@@ -438,6 +615,11 @@ template <>
 struct MoreequalDyadOp<JChar>: BadScalarDyadOp<JChar> {};
 }
 
+template <typename Arg>
+struct SimdOpTrait<IncrementMoreequalVerbNS::MoreequalDyadOp<Arg> > {
+  static const simd_op value = simd_op_moreequal;
+};
+
 class IncrementMoreequalVerb: public JArithmeticVerb<JInt> {
 public:
   IncrementMoreequalVerb():
@@ -445,6 +627,175 @@ public:
 			  ScalarDyad<IncrementMoreequalVerbNS::MoreequalDyadOp>::Instantiate(), 0) {}
 };
 
+// Euclid's algorithm on the magnitudes, which for the most negative value of T do not
+// fit back into T.
+template <typename T>
+typename boost::make_unsigned<T>::type magnitude_gcd(T a, T b) {
+  typedef typename boost::make_unsigned<T>::type U;
+  U x(a < 0 ? U(0) - U(a) : U(a)), y(b < 0 ? U(0) - U(b) : U(b));
+  while (y != 0) {
+    U t(x % y);
+    x = y;
+    y = t;
+  }
+  return x;
+}
+
+JFloat float_gcd(JFloat a, JFloat b);
+JComplex complex_gcd(JComplex a, JComplex b);
+
+// Only the gcd of two most negative values, or of one and zero, is too large for T.
+struct CheckedGcd {
+  template <typename T>
+  static T apply(T a, T b, T& overflow) {
+    T res(static_cast<T>(magnitude_gcd(a, b)));
+    overflow |= -static_cast<T>(res < 0);
+    return res;
+  }
+
+  static JFloat apply_float(JFloat a, JFloat b) { return float_gcd(a, b); }
+};
+
+struct CheckedLcm {
+  template <typename T>
+  static T apply(T a, T b, T& overflow) {
+    if (a == 0 || b == 0) return 0;
+    T gcd(CheckedGcd::apply(a, b, overflow));
+    if (gcd < 0) return 0;
+    return CheckedMultiply::apply(static_cast<T>(a / gcd), b, overflow);
+  }
+
+  static JFloat apply_float(JFloat a, JFloat b) {
+    return a == 0 || b == 0 ? 0 : a / float_gcd(a, b) * b;
+  }
+};
+
+namespace GcdOrVerbNS {
+
+template <typename Arg>
+struct GcdDyadOp: public std::binary_function<Arg, Arg, Arg> {
+  Arg operator()(Arg arg1, Arg arg2) const {
+    return static_cast<Arg>(magnitude_gcd(arg1, arg2));
+  }
+};
+
+template <>
+struct GcdDyadOp<JFloat>: public std::binary_function<JFloat, JFloat, JFloat> {
+  JFloat operator()(JFloat arg1, JFloat arg2) const {
+    return float_gcd(arg1, arg2);
+  }
+};
+
+template <>
+struct GcdDyadOp<JComplex>: public std::binary_function<JComplex, JComplex, JComplex> {
+  JComplex operator()(JComplex arg1, JComplex arg2) const {
+    return complex_gcd(arg1, arg2);
+  }
+};
+
+template <>
+struct GcdDyadOp<JInt>: public OverflowCheckedDyadOp<JInt, CheckedGcd> {};
+
+template <>
+struct GcdDyadOp<JInt64>: public OverflowCheckedDyadOp<JInt64, CheckedGcd> {};
+
+template <>
+struct GcdDyadOp<JBool>: public BitwiseDyadOp<BitOr> {};
+
+template <>
+struct GcdDyadOp<JBox>: public BadScalarDyadOp<JBox> {};
+
+template <>
+struct GcdDyadOp<JChar>: public BadScalarDyadOp<JChar> {};
+
+// +. y lists the real and imaginary parts of each atom along a new last axis.
+struct RealImagMonadOp {
+  JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const;
+};
+}
+
+class GcdOrVerb: public JArithmeticVerb<JInt> {
+public:
+  GcdOrVerb():
+    JArithmeticVerb<JInt>(DefaultMonad<GcdOrVerbNS::RealImagMonadOp>::Instantiate(rank_infinity, 
+										  GcdOrVerbNS::RealImagMonadOp()),
+			  ScalarDyad<GcdOrVerbNS::GcdDyadOp>::Instantiate(), 0) {}
+};
+
+namespace LcmAndVerbNS {
+
+template <typename Arg>
+struct LcmDyadOp: public std::binary_function<Arg, Arg, Arg> {
+  Arg operator()(Arg arg1, Arg arg2) const {
+    if (arg1 == Arg(0) || arg2 == Arg(0)) return Arg(0);
+    return arg1 / GcdOrVerbNS::GcdDyadOp<Arg>()(arg1, arg2) * arg2;
+  }
+};
+
+template <>
+struct LcmDyadOp<JInt>: public OverflowCheckedDyadOp<JInt, CheckedLcm> {};
+
+template <>
+struct LcmDyadOp<JInt64>: public OverflowCheckedDyadOp<JInt64, CheckedLcm> {};
+
+template <>
+struct LcmDyadOp<JBool>: public BitwiseDyadOp<BitAnd> {};
+
+template <>
+struct LcmDyadOp<JBox>: public BadScalarDyadOp<JBox> {};
+
+template <>
+struct LcmDyadOp<JChar>: public BadScalarDyadOp<JChar> {};
+
+// *. y lists the length and angle of each atom along a new last axis.
+struct LengthAngleMonadOp {
+  JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const;
+};
+}
+
+class LcmAndVerb: public JArithmeticVerb<JInt> {
+public:
+  LcmAndVerb():
+    JArithmeticVerb<JInt>(DefaultMonad<LcmAndVerbNS::LengthAngleMonadOp>::Instantiate(rank_infinity, 
+										     LcmAndVerbNS::LengthAngleMonadOp()),
+			  ScalarDyad<LcmAndVerbNS::LcmDyadOp>::Instantiate(), 1) {}
+};
+
+namespace NotVerbNS {
+
+template <typename Arg>
+struct NotMonadOp: public BadScalarMonadOp<Arg> {};
+
+template <>
+struct NotMonadOp<JBool>: public BitwiseMonadOp<BitNot> {};
+
+// -. y is 1 - y. Booleans flip bit by bit; everything else goes through the minus dyad.
+class NotMonad: public Monad {
+  Monad::Ptr flip;
+  Dyad::Ptr minus;
+
+public:
+  NotMonad(): Monad(0), flip(ScalarMonad<NotMonadOp>::Instantiate()), 
+	      minus(ScalarDyad<MinusDyadOp>::Instantiate()) {}
+
+  JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const;
+  JNoun::Ptr apply_owned(JMachine::Ptr m, const JNoun::Ptr& arg) const;
+};
+
+// x -. y is the items of x that are not cells of y.
+struct LessDyadOp {
+  JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const;
+};
+}
+
+class NotVerb: public JVerb {
+public:
+  NotVerb():
+    JVerb(Monad::Ptr(new NotVerbNS::NotMonad()),
+	  DefaultDyad<NotVerbNS::LessDyadOp>::Instantiate(rank_infinity, rank_infinity, 
+							  NotVerbNS::LessDyadOp())) {}
+};
+
 }
 		  
 #endif
@@ -8,25 +8,28 @@ JWord::Ptr JInsertTableAdverb::operator()(JMachine::Ptr, JWord::Ptr word) const
   return JWord::Ptr(new JInsertTableVerb(boost::static_pointer_cast<JVerb>(word)));
 }
 
-JInsertTableAdverb::JInsertTableVerb::MyMonad::MyMonad(shared_ptr<JVerb> verb):
+JInsertTableAdverb::JInsertTableVerb::MyMonad::MyMonad(JVerb::Ptr verb):
   Monad(rank_infinity), verb(verb) {}
 
   
 JNoun::Ptr JInsertTableAdverb::JInsertTableVerb::MyMonad::operator()(JMachine::Ptr m, 
 								     const JNoun& arg) const { 
   if (arg.is_scalar()) return arg.clone();
+
+  JNoun::Ptr reduced(verb->reduce(m, arg));
+  if (reduced) return reduced;
   
-  int first_dim = arg.get_dims()[0];
+  JSize first_dim = arg.get_dims()[0];
   if (first_dim == 1) { 
-    return arg.coordinate(1, 0);
+    return arg.coordinate(0);
   }
   if (first_dim == 0) {
     return verb->unit(arg.get_dims().suffix(-1));
   }
     
-  JNoun::Ptr res(arg.coordinate(1, first_dim - 1));
-  for (int i = first_dim - 2; i >= 0; --i) {
-    res = (*verb)(m, *arg.coordinate(1, i), *res);
+  JNoun::Ptr res(arg.coordinate(first_dim - 1));
+  for (JSize i = first_dim - 2; i >= 0; --i) {
+    res = (*verb)(m, *arg.coordinate(i), *res);
   }
   return res;
 }
@@ -40,9 +43,9 @@ JNoun::Ptr JInsertTableAdverb::JInsertTableVerb::MyDyad::operator()(JMachine::Pt
   return dyadic_apply(get_lrank(), get_rrank(), m, larg, rarg, *verb);
 }
 
-JInsertTableAdverb::JInsertTableVerb::JInsertTableVerb(shared_ptr<JVerb> verb): 
+JInsertTableAdverb::JInsertTableVerb::JInsertTableVerb(JVerb::Ptr verb): 
   JVerb(shared_ptr<Monad>(new MyMonad(verb)), 
-	shared_ptr<Dyad>(new MyDyad(verb))) {}
+	shared_ptr<Dyad>(new MyDyad(verb))), verb(verb) {}
 
 JNoun::Ptr PrefixInfixAdverb::PrefixInfixVerb::MonadOp::operator()(JMachine::Ptr m, const JNoun& arg) const { 
   Dimensions dims(arg.get_rank() == 0 ? Dimensions(1,1) : arg.get_dims() );
@@ -53,7 +56,7 @@ JNoun::Ptr PrefixInfixAdverb::PrefixInfixVerb::MonadOp::operator()(JMachine::Ptr
     return arg.clone();
   }
 
-  for (int i = 0; i < dims[0]; ++i) {
+  for (JSize i = 0; i < dims[0]; ++i) {
     JNoun::Ptr slice(arg.subarray(0, i + 1)); 
     JNoun::Ptr ans((*verb)(m, *slice));
     res.add_noun(ans);
@@ -64,19 +67,19 @@ JNoun::Ptr PrefixInfixAdverb::PrefixInfixVerb::MonadOp::operator()(JMachine::Ptr
 
 JNoun::Ptr 
 PrefixInfixAdverb::PrefixInfixVerb::DyadOp::operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
-  JArray<JInt> ints(require_type<JInt>(larg));
-  int len = *(ints.begin());
+  JArray<JInt64> ints(require_type<JInt64>(larg));
+  JSize len = *(ints.begin());
   
   Dimensions dims(rarg.get_rank() == 0 ? Dimensions(1,1): rarg.get_dims());
   
-  int first_elem = dims[0];
+  JSize first_elem = dims[0];
   
   if (len < 0) { 
     len = -len;
-    int nr_of_cycles = first_elem % len == 0 ? first_elem / len : first_elem / len + 1;
+    JSize nr_of_cycles = first_elem % len == 0 ? first_elem / len : first_elem / len + 1;
     JResult res(Dimensions(1, nr_of_cycles));
 	  
-    for(int i = 0; i < nr_of_cycles; ++i) { 
+    for(JSize i = 0; i < nr_of_cycles; ++i) { 
       JNoun::Ptr slice(rarg.subarray(i * len, std::min((i + 1) * len, first_elem)));
       res.add_noun((*verb)(m, *slice));
     } 
@@ -88,7 +91,7 @@ PrefixInfixAdverb::PrefixInfixVerb::DyadOp::operator()(JMachine::Ptr m, const JN
     } 
 	  
     JResult res(Dimensions(1, first_elem - len + 1));
-    for (int i = 0; i + len <= first_elem; ++i) {
+    for (JSize i = 0; i + len <= first_elem; ++i) {
       res.add_noun((*verb)(m, *rarg.subarray(i, i + len)));
     }
 	  
@@ -28,9 +28,14 @@ class JInsertTableAdverb: public JAdverb {
       JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const;
     };
 
+    JVerb::Ptr verb;
+
   public:
     JInsertTableVerb(JVerb::Ptr verb);
-      
+
+    JNoun::Ptr apply_to_cells(JMachine::Ptr m, const JNoun& arg, int rank) const {
+      return verb->reduce_cells(m, arg, rank);
+    }
   };	
 
 public:
@@ -1,4 +1,8 @@
 #include "JBasicConjunctions.hpp"
+#include "JDelimited.hpp"
+#include "JSerialize.hpp"
+#include "VerbHelpers.hpp"
+#include <streambuf>
 
 namespace J {
 JWord::Ptr RankConjunction::operator()(JMachine::Ptr, JWord::Ptr lword, JWord::Ptr rword) const {
@@ -7,8 +11,8 @@ JWord::Ptr RankConjunction::operator()(JMachine::Ptr, JWord::Ptr lword, JWord::P
     throw JIllegalGrammarClassException();
   }
     
-  shared_ptr<JVerb> verb = boost::static_pointer_cast<JVerb>(lword);
-  shared_ptr<JNoun> new_rank = boost::static_pointer_cast<JNoun>(rword);
+  JVerb::Ptr verb = boost::static_pointer_cast<JVerb>(lword);
+  JNoun::Ptr new_rank = boost::static_pointer_cast<JNoun>(rword);
     
   JArray<JInt> array = require_type<JInt>(*new_rank);
   if (array.get_rank() > 1 || 
@@ -28,4 +32,65 @@ JWord::Ptr RankConjunction::operator()(JMachine::Ptr, JWord::Ptr lword, JWord::P
 
   assert(0);
 }
+
+class CharArrayBuffer: public std::streambuf {
+public:
+  CharArrayBuffer(char* begin, char* end) { setp(begin, end); }
+};
+
+struct RetainContent {
+  JArray<JChar>::container_ptr content;
+
+  RetainContent(JArray<JChar>::container_ptr content): content(content) {}
+  void operator()(void*) const {}
+};
+
+JNoun::Ptr ForeignConjunction::EncodeOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  intrusive_ptr<JArray<JChar> > res(allocated_array<JChar>(Dimensions(1, encoded_size(arg))));
+  CharArrayBuffer buffer(res->begin(), res->end());
+  std::ostream os(&buffer);
+  encode_noun(os, arg);
+  return res;
+}
+
+JNoun::Ptr ForeignConjunction::DecodeOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  if (arg.get_value_type() != j_value_type_char || arg.get_rank() != 1) {
+    throw JIllegalValueTypeException();
+  }
+
+  const JArray<JChar>& bytes(static_cast<const JArray<JChar>&>(arg));
+  JArray<JChar>::container_ptr content(bytes.get_content());
+  // Arena buffers move when their sentence ends, so those are decoded into copies.
+  shared_ptr<void> owner;
+  if (!content->is_arena_allocated()) owner = shared_ptr<void>(content.get(), RetainContent(content));
+  return decode_noun(bytes.begin(), bytes.get_dims().number_of_elems(), owner);
+}
+
+JNoun::Ptr ForeignConjunction::NoDyadOp::operator()(JMachine::Ptr, const JNoun&, const JNoun&) const {
+  throw JUnimplementedOperationException();
+}
+
+JWord::Ptr ForeignConjunction::operator()(JMachine::Ptr, JWord::Ptr lword, JWord::Ptr rword) const {
+  if (lword->get_grammar_class() != grammar_class_noun || 
+      rword->get_grammar_class() != grammar_class_noun) {
+    throw JIllegalGrammarClassException();
+  }
+
+  JArray<JInt> family(require_type<JInt>(*boost::static_pointer_cast<JNoun>(lword)));
+  JArray<JInt> code(require_type<JInt>(*boost::static_pointer_cast<JNoun>(rword)));
+  if (!family.is_scalar() || !code.is_scalar()) {
+    throw JIllegalDimensionsException();
+  }
+
+  Dyad::Ptr dyad(DefaultDyad<NoDyadOp>::Instantiate(rank_infinity, rank_infinity, NoDyadOp()));
+  if (family.get_scalar_value() == 3 && code.get_scalar_value() == 1) {
+    return JWord::Ptr(new JVerb(DefaultMonad<EncodeOp>::Instantiate(rank_infinity, EncodeOp()), dyad));
+  } else if (family.get_scalar_value() == 3 && code.get_scalar_value() == 2) {
+    return JWord::Ptr(new JVerb(DefaultMonad<DecodeOp>::Instantiate(rank_infinity, DecodeOp()), dyad));
+  } else if (family.get_scalar_value() == 1 && code.get_scalar_value() == 50) {
+    return JWord::Ptr(new LoadDelimitedVerb());
+  }
+
+  throw JUnimplementedOperationException();
+}
 }
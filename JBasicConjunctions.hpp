@@ -15,7 +15,16 @@ class RankConjunction: public JConjunction {
 
     public:
       MyMonad(int rank, JVerb::Ptr verb): Monad(rank), verb(verb) {}
+      bool is_elementwise() const { return verb->is_monad_elementwise(); }
+
       JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const {
+	if (is_elementwise()) return (*verb)(m, arg);
+
+	int rank(get_rank() < 0 ? std::max(0, arg.get_rank() + get_rank()) : get_rank());
+	if (rank > 0 && rank < arg.get_rank()) {
+	  JNoun::Ptr res(verb->apply_to_cells(m, arg, rank));
+	  if (res) return res;
+	}
 	return monadic_apply(get_rank(), m, arg, *verb);
       }
     };
@@ -25,7 +34,13 @@ class RankConjunction: public JConjunction {
 	
     public:
       MyDyad(int lrank, int rrank, JVerb::Ptr verb): Dyad(lrank, rrank),  verb(verb) {}
+      // Cells of rank 0 on both sides agree the way an elementwise verb's own arguments do.
+      bool is_elementwise() const { 
+	return get_lrank() == 0 && get_rrank() == 0 && verb->is_dyad_elementwise();
+      }
+
       JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
+	if (is_elementwise()) return (*verb)(m, larg, rarg);
 	return dyadic_apply(get_lrank(), get_rrank(), m, larg, rarg, *verb);
       }
     };
@@ -39,6 +54,24 @@ public:
   JWord::Ptr operator()(JMachine::Ptr m, JWord::Ptr lword, JWord::Ptr rword) const;
   RankConjunction(): JConjunction() {}
 };
+
+class ForeignConjunction: public JConjunction {
+  struct EncodeOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const;
+  };
+
+  struct DecodeOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const;
+  };
+
+  struct NoDyadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun&, const JNoun&) const;
+  };
+
+public:
+  JWord::Ptr operator()(JMachine::Ptr m, JWord::Ptr lword, JWord::Ptr rword) const;
+  ForeignConjunction(): JConjunction() {}
+};
 }
 
 #endif
@@ -0,0 +1,45 @@
+#include "JBuffer.hpp"
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+namespace J {
+
+void* allocate_aligned(std::size_t bytes) {
+  std::size_t alignment = bytes >= hugepage_size ? hugepage_size : buffer_alignment;
+  void* ptr = 0;
+  if (posix_memalign(&ptr, alignment, bytes == 0 ? alignment : bytes) != 0) {
+    throw std::bad_alloc();
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (bytes >= hugepage_size) {
+    madvise(ptr, bytes - bytes % hugepage_size, MADV_HUGEPAGE);
+  }
+#endif
+
+  return ptr;
+}
+
+void free_aligned(void* ptr) {
+  free(ptr);
+}
+
+std::size_t count_bits(JBitIterator begin, JBitIterator end) {
+  std::size_t count = 0;
+  for (; begin != end && !word_aligned(begin); ++begin) {
+    if (*begin) ++count;
+  }
+
+  const JBitWord* word(first_word(begin));
+  std::size_t n = end - begin;
+  for (std::size_t i = 0; i < n / bits_per_word; ++i) {
+    count += __builtin_popcountl(word[i]);
+  }
+  if (n % bits_per_word) {
+    count += __builtin_popcountl(word[n / bits_per_word] & ((JBitWord(1) << (n % bits_per_word)) - 1));
+  }
+  return count;
+}
+
+}
@@ -0,0 +1,237 @@
+#ifndef JBUFFER_HPP
+#define JBUFFER_HPP
+
+#include <cstddef>
+#include <cassert>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include "JGrammar.hpp"
+#include "JArena.hpp"
+
+namespace J {
+using boost::shared_ptr;
+
+const std::size_t buffer_alignment = 64;
+const std::size_t hugepage_size = 2 * 1024 * 1024;
+
+void* allocate_aligned(std::size_t bytes);
+void free_aligned(void* ptr);
+
+template <typename T>
+class JBuffer: public JBufferStorage, public JRefCounted<JBuffer<T> > {
+  std::size_t size;
+
+  explicit JBuffer(std::size_t size): JBufferStorage(size * sizeof(T), !needs_construction()), size(size) {}
+  JBuffer(const T* data, std::size_t size, shared_ptr<void> owner, bool writable): 
+    JBufferStorage(const_cast<T*>(data), size * sizeof(T), owner, writable), size(size) {}
+
+  static bool needs_construction() {
+    return !boost::has_trivial_destructor<T>::value;
+  }
+
+public:
+  typedef JRef<JBuffer<T> > Ptr;
+  typedef T* iterator;
+
+  static Ptr InstantiateFilled(std::size_t size, const T& val) {
+    Ptr buf(new JBuffer<T>(size));
+    std::uninitialized_fill(buf->begin(), buf->end(), val);
+    return buf;
+  }
+
+  static Ptr Instantiate(std::size_t size) {
+    if (needs_construction()) {
+      return InstantiateFilled(size, JTypeTrait<T>::base_elem());
+    }
+    return Ptr(new JBuffer<T>(size));
+  }
+
+  template <typename Iterator>
+  static Ptr InstantiateCopy(Iterator begin, Iterator end) {
+    Ptr buf(new JBuffer<T>(std::distance(begin, end)));
+    std::uninitialized_copy(begin, end, buf->begin());
+    return buf;
+  }
+
+  // Wraps memory owned elsewhere without copying it; owner is kept alive as long as the
+  // buffer is, so a custom deleter can be attached to it. Unless the memory is declared
+  // writable, verbs copy instead of writing into it.
+  static Ptr InstantiateExternal(const T* data, std::size_t size, shared_ptr<void> owner, 
+				 bool writable = false) {
+    assert(!needs_construction() && owner);
+    return Ptr(new JBuffer<T>(data, size, owner, writable));
+  }
+
+  ~JBuffer() {
+    if (needs_construction() && !is_external()) {
+      for (T* p = begin(); p != end(); ++p) p->~T();
+    }
+  }
+
+  T* begin() const { return static_cast<T*>(get_data()); }
+  T* end() const { return begin() + size; }
+  std::size_t get_size() const { return size; }
+};
+
+typedef boost::uint64_t JBitWord;
+const std::size_t bits_per_word = 64;
+
+class JBitReference {
+  JBitWord* word;
+  JBitWord mask;
+
+public:
+  JBitReference(JBitWord* word, JBitWord mask): word(word), mask(mask) {}
+
+  operator bool() const { return (*word & mask) != 0; }
+
+  JBitReference& operator=(bool val) {
+    if (val) *word |= mask; else *word &= ~mask;
+    return *this;
+  }
+
+  JBitReference& operator=(const JBitReference& ref) {
+    return *this = static_cast<bool>(ref);
+  }
+};
+
+class JBitIterator: public std::iterator<std::random_access_iterator_tag, bool, std::ptrdiff_t,
+					  void, JBitReference> {
+  JBitWord* words;
+  std::ptrdiff_t pos;
+
+public:
+  JBitIterator(): words(0), pos(0) {}
+  JBitIterator(JBitWord* words, std::ptrdiff_t pos): words(words), pos(pos) {}
+
+  JBitWord* get_words() const { return words; }
+  std::ptrdiff_t get_position() const { return pos; }
+
+  JBitReference operator*() const {
+    return JBitReference(words + pos / bits_per_word, JBitWord(1) << (pos % bits_per_word));
+  }
+  JBitReference operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
+  JBitIterator& operator++() { ++pos; return *this; }
+  JBitIterator& operator--() { --pos; return *this; }
+  JBitIterator operator++(int) { JBitIterator old(*this); ++pos; return old; }
+  JBitIterator operator--(int) { JBitIterator old(*this); --pos; return old; }
+  JBitIterator& operator+=(std::ptrdiff_t n) { pos += n; return *this; }
+  JBitIterator& operator-=(std::ptrdiff_t n) { pos -= n; return *this; }
+  JBitIterator operator+(std::ptrdiff_t n) const { return JBitIterator(words, pos + n); }
+  JBitIterator operator-(std::ptrdiff_t n) const { return JBitIterator(words, pos - n); }
+  std::ptrdiff_t operator-(const JBitIterator& it) const { return pos - it.pos; }
+
+  bool operator==(const JBitIterator& it) const { return words == it.words && pos == it.pos; }
+  bool operator!=(const JBitIterator& it) const { return !(*this == it); }
+  bool operator<(const JBitIterator& it) const { return pos < it.pos; }
+  bool operator>(const JBitIterator& it) const { return pos > it.pos; }
+  bool operator<=(const JBitIterator& it) const { return pos <= it.pos; }
+  bool operator>=(const JBitIterator& it) const { return pos >= it.pos; }
+};
+
+std::size_t count_bits(JBitIterator begin, JBitIterator end);
+
+inline bool word_aligned(JBitIterator iter) {
+  return iter.get_position() % bits_per_word == 0;
+}
+
+inline JBitWord* first_word(JBitIterator iter) {
+  return iter.get_words() + iter.get_position() / bits_per_word;
+}
+
+inline void store_tail(JBitWord* out, JBitWord val, std::size_t bits) {
+  JBitWord mask((JBitWord(1) << bits) - 1);
+  *out = (*out & ~mask) | (val & mask);
+}
+
+template <typename WordOp>
+JBitIterator transform_bits(JBitIterator first, JBitIterator last, JBitIterator out, WordOp op) {
+  if (!word_aligned(first) || !word_aligned(out)) {
+    for (; first != last; ++first, ++out) {
+      *out = (op(JBitWord(*first)) & 1) != 0;
+    }
+    return out;
+  }
+
+  std::size_t n = last - first;
+  const JBitWord* in(first_word(first));
+  JBitWord* res(first_word(out));
+  for (std::size_t i = 0; i < n / bits_per_word; ++i) {
+    res[i] = op(in[i]);
+  }
+  if (n % bits_per_word) {
+    store_tail(res + n / bits_per_word, op(in[n / bits_per_word]), n % bits_per_word);
+  }
+  return out + n;
+}
+
+template <typename WordOp>
+JBitIterator transform_bits(JBitIterator first1, JBitIterator last1, JBitIterator first2,
+			    JBitIterator out, WordOp op) {
+  if (!word_aligned(first1) || !word_aligned(first2) || !word_aligned(out)) {
+    for (; first1 != last1; ++first1, ++first2, ++out) {
+      *out = (op(JBitWord(*first1), JBitWord(*first2)) & 1) != 0;
+    }
+    return out;
+  }
+
+  std::size_t n = last1 - first1;
+  const JBitWord* in1(first_word(first1));
+  const JBitWord* in2(first_word(first2));
+  JBitWord* res(first_word(out));
+  for (std::size_t i = 0; i < n / bits_per_word; ++i) {
+    res[i] = op(in1[i], in2[i]);
+  }
+  if (n % bits_per_word) {
+    std::size_t last = n / bits_per_word;
+    store_tail(res + last, op(in1[last], in2[last]), n % bits_per_word);
+  }
+  return out + n;
+}
+
+template <>
+class JBuffer<JBool>: public JBufferStorage, public JRefCounted<JBuffer<JBool> > {
+  std::size_t size;
+
+  static std::size_t words_for(std::size_t size) {
+    return (size + bits_per_word - 1) / bits_per_word;
+  }
+
+  explicit JBuffer(std::size_t size): JBufferStorage(words_for(size) * sizeof(JBitWord), true), size(size) {}
+
+  JBitWord* words() const { return static_cast<JBitWord*>(get_data()); }
+
+public:
+  typedef JRef<JBuffer<JBool> > Ptr;
+  typedef JBitIterator iterator;
+
+  static Ptr InstantiateFilled(std::size_t size, JBool val) {
+    Ptr buf(new JBuffer<JBool>(size));
+    std::fill(buf->words(), buf->words() + words_for(size), val ? ~JBitWord(0) : JBitWord(0));
+    return buf;
+  }
+
+  static Ptr Instantiate(std::size_t size) {
+    return Ptr(new JBuffer<JBool>(size));
+  }
+
+  template <typename Iterator>
+  static Ptr InstantiateCopy(Iterator begin, Iterator end) {
+    Ptr buf(new JBuffer<JBool>(std::distance(begin, end)));
+    std::copy(begin, end, buf->begin());
+    return buf;
+  }
+
+  iterator begin() const { return iterator(words(), 0); }
+  iterator end() const { return iterator(words(), size); }
+  std::size_t get_size() const { return size; }
+};
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include "JBufferPool.hpp"
+#include "JBuffer.hpp"
+
+namespace J {
+
+// Blocks cached by threads that have exited, bounded by the retention limit and
+// handed to whichever thread misses in its own cache next.  The lock also guards
+// every live pool's large classes, so any thread can return idle large blocks.
+static boost::mutex shared_lock;
+vector<void*> JBufferPool::shared_classes[JBufferPool::class_count];
+std::size_t JBufferPool::shared_bytes = 0;
+
+// Like the owner below, never destroyed.
+static vector<JBufferPool*>& live_pools() {
+  static vector<JBufferPool*>* pools = new vector<JBufferPool*>();
+  return *pools;
+}
+
+// The owner runs JBufferPool::retire when a thread exits; thread_pool is the
+// unowned fast path to the same pool.  The owner is never destroyed, so buffers
+// freed by static destructors still find a pool.
+static boost::thread_specific_ptr<JBufferPool>& pool_owner() {
+  static boost::thread_specific_ptr<JBufferPool>* owner =
+    new boost::thread_specific_ptr<JBufferPool>(&JBufferPool::retire);
+  return *owner;
+}
+
+static __thread JBufferPool* thread_pool = 0;
+
+std::size_t JBufferPool::retention_limit = JBufferPool::default_retention_limit;
+
+JBufferPool::JBufferPool(): retained(0), large_retained(0), operations(0) {
+  boost::mutex::scoped_lock lock(shared_lock);
+  live_pools().push_back(this);
+}
+
+JBufferPool::~JBufferPool() {
+  for (int i = 0; i < class_count; ++i) {
+    for (vector<CachedBuffer>::iterator j = classes[i].begin(); j != classes[i].end(); ++j) {
+      free_aligned(j->data);
+    }
+  }
+}
+
+JBufferPool& JBufferPool::local() {
+  if (!thread_pool) {
+    thread_pool = new JBufferPool();
+    pool_owner().reset(thread_pool);
+  }
+  return *thread_pool;
+}
+
+void JBufferPool::retire(JBufferPool* pool) {
+  if (pool == thread_pool) thread_pool = 0;
+  {
+    boost::mutex::scoped_lock lock(shared_lock);
+    vector<JBufferPool*>& pools(live_pools());
+    pools.erase(std::remove(pools.begin(), pools.end(), pool), pools.end());
+    for (int i = 0; i < class_count; ++i) {
+      vector<CachedBuffer>& cached(pool->classes[i]);
+      while (!cached.empty() && shared_bytes + class_size(i) <= retention_limit) {
+	shared_classes[i].push_back(cached.back().data);
+	shared_bytes += class_size(i);
+	cached.pop_back();
+      }
+    }
+  }
+  delete pool;
+}
+
+void* JBufferPool::take_shared(int index) {
+  boost::mutex::scoped_lock lock(shared_lock);
+  return take_shared_locked(index);
+}
+
+void* JBufferPool::take_shared_locked(int index) {
+  if (shared_classes[index].empty()) return 0;
+  void* data(shared_classes[index].back());
+  shared_classes[index].pop_back();
+  shared_bytes -= class_size(index);
+  return data;
+}
+
+int JBufferPool::size_class(std::size_t bytes, std::size_t* class_bytes) {
+  if (bytes <= buffer_alignment) {
+    *class_bytes = buffer_alignment;
+    return 0;
+  }
+  if (bytes > max_pooled_bytes) return -1;
+
+  int msb(63 - __builtin_clzl(bytes - 1));
+  std::size_t power(std::size_t(1) << msb), quarter(power / 4);
+  std::size_t step((bytes - 1 - power) / quarter);
+  *class_bytes = power + (step + 1) * quarter;
+  return 1 + (msb - 6) * 4 + step;
+}
+
+std::size_t JBufferPool::class_size(int index) {
+  if (index == 0) return buffer_alignment;
+  std::size_t power(std::size_t(1) << (6 + (index - 1) / 4));
+  return power + ((index - 1) % 4 + 1) * (power / 4);
+}
+
+int JBufferPool::large_class() {
+  std::size_t large_bytes;
+  return size_class(large_buffer_bytes, &large_bytes);
+}
+
+void JBufferPool::trim_locked(std::time_t now) {
+  for (int i = large_class(); i < class_count; ++i) {
+    vector<CachedBuffer>& cached(classes[i]);
+    vector<CachedBuffer>::iterator kept(cached.begin());
+    for (vector<CachedBuffer>::iterator j = cached.begin(); j != cached.end(); ++j) {
+      if (now - j->released > large_idle_seconds) {
+	free_aligned(j->data);
+	large_retained -= class_size(i);
+      } else {
+	*kept++ = *j;
+      }
+    }
+    cached.erase(kept, cached.end());
+  }
+}
+
+void JBufferPool::sweep_locked(std::time_t now) {
+  vector<JBufferPool*>& pools(live_pools());
+  for (vector<JBufferPool*>::iterator i = pools.begin(); i != pools.end(); ++i) {
+    (*i)->trim_locked(now);
+  }
+}
+
+void JBufferPool::note_operation() {
+  if ((++operations & 0xff) == 0) trim_idle(std::time(0));
+}
+
+void* JBufferPool::allocate(std::size_t bytes) {
+  std::size_t class_bytes;
+  int index(size_class(bytes, &class_bytes));
+  if (index < 0) return allocate_aligned(bytes);
+
+  JBufferPool& pool(local());
+  pool.note_operation();
+  vector<CachedBuffer>& cached(pool.classes[index]);
+  if (index >= large_class()) {
+    boost::mutex::scoped_lock lock(shared_lock);
+    sweep_locked(std::time(0));
+    if (cached.empty()) {
+      void* shared(take_shared_locked(index));
+      if (shared) return shared;
+    } else {
+      void* data(cached.back().data);
+      cached.pop_back();
+      pool.large_retained -= class_bytes;
+      return data;
+    }
+    lock.unlock();
+    return allocate_aligned(class_bytes);
+  }
+  if (cached.empty()) {
+    void* shared(take_shared(index));
+    return shared ? shared : allocate_aligned(class_bytes);
+  }
+
+  void* data(cached.back().data);
+  cached.pop_back();
+  pool.retained -= class_bytes;
+  return data;
+}
+
+void JBufferPool::release(void* data, std::size_t bytes) {
+  std::size_t class_bytes;
+  int index(size_class(bytes, &class_bytes));
+  JBufferPool& pool(local());
+  if (index >= large_class()) {
+    std::time_t now(std::time(0));
+    boost::mutex::scoped_lock lock(shared_lock);
+    sweep_locked(now);
+    if (pool.retained + pool.large_retained + class_bytes <= retention_limit) {
+      pool.classes[index].push_back(CachedBuffer(data, now));
+      pool.large_retained += class_bytes;
+      return;
+    }
+  } else if (index >= 0 && pool.retained + class_bytes <= retention_limit) {
+    pool.note_operation();
+    pool.classes[index].push_back(CachedBuffer(data, 0));
+    pool.retained += class_bytes;
+    return;
+  }
+  free_aligned(data);
+}
+
+std::size_t JBufferPool::get_retained_bytes() {
+  JBufferPool& pool(local());
+  boost::mutex::scoped_lock lock(shared_lock);
+  return pool.retained + pool.large_retained;
+}
+
+void JBufferPool::trim_idle(std::time_t now) {
+  boost::mutex::scoped_lock lock(shared_lock);
+  sweep_locked(now);
+}
+
+std::size_t JBufferPool::get_shared_bytes() {
+  boost::mutex::scoped_lock lock(shared_lock);
+  return shared_bytes;
+}
+
+void JBufferPool::release_thread_cache() {
+  pool_owner().reset();
+  thread_pool = 0;
+}
+
+}
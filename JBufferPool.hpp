@@ -0,0 +1,64 @@
+#ifndef JBUFFERPOOL_HPP
+#define JBUFFERPOOL_HPP
+
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+namespace J {
+using std::vector;
+
+class JBufferPool {
+  struct CachedBuffer {
+    void* data;
+    std::time_t released;
+
+    CachedBuffer(void* data, std::time_t released): data(data), released(released) {}
+  };
+
+  static const int class_count = 97;
+  static std::size_t retention_limit;
+  static vector<void*> shared_classes[class_count];
+  static std::size_t shared_bytes;
+
+  // Classes from large_class() up are guarded by the shared lock.
+  vector<CachedBuffer> classes[class_count];
+  std::size_t retained;
+  std::size_t large_retained;
+  unsigned int operations;
+
+  JBufferPool();
+  ~JBufferPool();
+  JBufferPool(const JBufferPool&);
+  JBufferPool& operator=(const JBufferPool&);
+
+  static JBufferPool& local();
+  static void* take_shared(int index);
+  static void* take_shared_locked(int index);
+  static int size_class(std::size_t bytes, std::size_t* class_bytes);
+  static std::size_t class_size(int index);
+  static int large_class();
+  static void sweep_locked(std::time_t now);
+  void trim_locked(std::time_t now);
+  void note_operation();
+
+public:
+  static const std::size_t max_pooled_bytes = std::size_t(1) << 30;
+  static const std::size_t large_buffer_bytes = 2 * 1024 * 1024;
+  static const std::size_t default_retention_limit = 64 * 1024 * 1024;
+  static const int large_idle_seconds = 10;
+
+  static void* allocate(std::size_t bytes);
+  static void release(void* data, std::size_t bytes);
+
+  static void set_retention_limit(std::size_t bytes) { retention_limit = bytes; }
+  static std::size_t get_retained_bytes();
+  static std::size_t get_shared_bytes();
+  static void trim_idle(std::time_t now);
+  static void release_thread_cache();
+  static void retire(JBufferPool* pool);
+};
+
+}
+
+#endif
@@ -8,7 +8,7 @@
 namespace J {
 class JConjunction: public JWord {
 public:
-  typedef shared_ptr<JConjunction> Ptr;
+  typedef JRef<JConjunction> Ptr;
   virtual ~JConjunction() {}
   JConjunction(): JWord(grammar_class_conjunction) {}
   virtual JWord::Ptr operator()(JMachine::Ptr m, JWord::Ptr lword, JWord::Ptr rword) const = 0;
@@ -0,0 +1,448 @@
+#include "JDelimited.hpp"
+#include "VerbHelpers.hpp"
+#include "JExceptions.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <boost/thread.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace J {
+
+const std::size_t min_chunk_bytes = 1024 * 1024;
+const int max_int_digits = 9;
+const int max_int64_digits = 18;
+
+struct ColumnShape {
+  bool fractional;
+  int digits;
+
+  ColumnShape(): fractional(false), digits(0) {}
+
+  void merge(const ColumnShape& shape) {
+    fractional = fractional || shape.fractional;
+    digits = std::max(digits, shape.digits);
+  }
+
+  j_value_type value_type() const {
+    if (fractional || digits > max_int64_digits) return j_value_type_float;
+    return digits > max_int_digits ? j_value_type_int64 : j_value_type_int;
+  }
+};
+
+struct ColumnSink {
+  j_value_type type;
+  char* base;
+  std::size_t stride;
+
+  ColumnSink(j_value_type type, char* base, std::size_t stride): type(type), base(base), stride(stride) {}
+};
+
+inline const char* line_end(const char* p, const char* end) {
+  const char* nl(static_cast<const char*>(std::memchr(p, '\n', end - p)));
+  return nl ? nl : end;
+}
+
+inline const char* trim_line(const char* begin, const char* end) {
+  return end > begin && end[-1] == '\r' ? end - 1 : end;
+}
+
+inline const char* field_end(const char* p, const char* end, char delimiter) {
+  while (p != end && *p != delimiter) ++p;
+  return p;
+}
+
+JInt64 parse_integer(const char* p, const char* end) {
+  bool negative(p != end && (*p == '-' || *p == '_'));
+  if (p != end && (*p == '-' || *p == '_' || *p == '+')) ++p;
+
+  JInt64 value(0);
+  for (; p != end; ++p) {
+    if (*p < '0' || *p > '9') throw JIllegalSyntaxException("Malformed integer field");
+    value = value * 10 + (*p - '0');
+  }
+  return negative ? -value : value;
+}
+
+JFloat parse_float_slowly(const char* begin, const char* end) {
+  char buffer[64];
+  std::size_t length(end - begin);
+  if (length >= sizeof(buffer)) throw JIllegalSyntaxException("Malformed numeric field");
+  std::copy(begin, end, buffer);
+  buffer[length] = 0;
+  if (buffer[0] == '_') buffer[0] = '-';
+
+  char* stop;
+  JFloat value(std::strtod(buffer, &stop));
+  if (stop != buffer + length) throw JIllegalSyntaxException("Malformed numeric field");
+  return value;
+}
+
+// Exact whenever the digits fit in a double's mantissa and the power of ten is exactly
+// representable; everything else goes through strtod.
+JFloat parse_float(const char* begin, const char* end) {
+  static const JFloat powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  const char* p(begin);
+  bool negative(p != end && (*p == '-' || *p == '_'));
+  if (p != end && (*p == '-' || *p == '_' || *p == '+')) ++p;
+  if (p == end) {
+    if (negative && p - begin == 1 && *begin == '_') return std::numeric_limits<JFloat>::infinity();
+    return 0;
+  }
+  if (*p == '_' && p + 1 == end) {
+    return negative ? -std::numeric_limits<JFloat>::infinity() : std::numeric_limits<JFloat>::infinity();
+  }
+
+  boost::uint64_t mantissa(0);
+  int digits(0), exponent(0);
+  bool seen_digit(false);
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    seen_digit = true;
+    if (mantissa || *p != '0') ++digits;
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p) {
+      seen_digit = true;
+      if (mantissa || *p != '0') ++digits;
+      mantissa = mantissa * 10 + (*p - '0');
+      --exponent;
+    }
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    const char* exp_begin(++p);
+    bool exp_negative(p != end && (*p == '-' || *p == '_'));
+    if (p != end && (*p == '-' || *p == '_' || *p == '+')) ++p;
+    int e(0);
+    for (; p != end && *p >= '0' && *p <= '9' && e < 10000; ++p) e = e * 10 + (*p - '0');
+    if (p == exp_begin) return parse_float_slowly(begin, end);
+    exponent += exp_negative ? -e : e;
+  }
+
+  if (p != end || !seen_digit) return parse_float_slowly(begin, end);
+  if (digits > 15 || exponent < -22 || exponent > 22) return parse_float_slowly(begin, end);
+
+  JFloat value(static_cast<JFloat>(mantissa));
+  value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+  return negative ? -value : value;
+}
+
+int count_fields(const char* begin, const char* end, char delimiter) {
+  return std::count(begin, end, delimiter) + 1;
+}
+
+class Chunk {
+  const char* begin;
+  const char* end;
+  char delimiter;
+  int columns;
+
+public:
+  JSize rows;
+  JSize first_row;
+  vector<ColumnShape> shapes;
+  const vector<ColumnSink>* sinks;
+  string error;
+  bool ragged;
+
+  Chunk(const char* begin, const char* end, char delimiter, int columns):
+    begin(begin), end(end), delimiter(delimiter), columns(columns), rows(0), first_row(0),
+    shapes(columns), sinks(0), error(), ragged(false) {}
+
+  void scan();
+  void parse();
+};
+
+void Chunk::scan() {
+  for (const char* line = begin; line < end; ++line) {
+    const char* stop(trim_line(line, line_end(line, end)));
+    if (stop != line) {
+      int column(0);
+      for (const char* field = line; ; ++field) {
+	const char* fend(field_end(field, stop, delimiter));
+	if (column == columns) {
+	  ragged = true;
+	  return;
+	}
+	ColumnShape& shape(shapes[column++]);
+	int digits(0);
+	for (const char* p = field; p != fend; ++p) {
+	  if (*p >= '0' && *p <= '9') {
+	    ++digits;
+	  } else if (p != field || (*p != '-' && *p != '_' && *p != '+')) {
+	    shape.fractional = true;
+	  }
+	}
+	if (digits == 0 && fend != field) shape.fractional = true;
+	shape.digits = std::max(shape.digits, digits);
+	field = fend;
+	if (field == stop) break;
+      }
+      if (column != columns) {
+	ragged = true;
+	return;
+      }
+      ++rows;
+    }
+    line = line_end(line, end);
+  }
+}
+
+void Chunk::parse() {
+  try {
+    JSize row(first_row);
+    for (const char* line = begin; line < end; ++line) {
+      const char* stop(trim_line(line, line_end(line, end)));
+      if (stop != line) {
+	const char* field(line);
+	for (vector<ColumnSink>::const_iterator sink = sinks->begin(); sink != sinks->end(); ++sink) {
+	  const char* fend(field_end(field, stop, delimiter));
+	  char* out(sink->base + row * sink->stride);
+	  switch (sink->type) {
+	  case j_value_type_int:
+	    *reinterpret_cast<JInt*>(out) = static_cast<JInt>(parse_integer(field, fend));
+	    break;
+	  case j_value_type_int64:
+	    *reinterpret_cast<JInt64*>(out) = parse_integer(field, fend);
+	    break;
+	  default:
+	    *reinterpret_cast<JFloat*>(out) = parse_float(field, fend);
+	    break;
+	  }
+	  field = fend + 1;
+	}
+	++row;
+      }
+      line = line_end(line, end);
+    }
+  } catch (std::exception& e) {
+    error = e.what();
+  }
+}
+
+template <void (Chunk::*Step)()>
+class ChunkTask {
+  Chunk* chunk;
+
+public:
+  ChunkTask(Chunk* chunk): chunk(chunk) {}
+  void operator()() const { (chunk->*Step)(); }
+};
+
+template <void (Chunk::*Step)()>
+void run_chunks(vector<Chunk>& chunks) {
+  if (chunks.size() == 1) {
+    (chunks[0].*Step)();
+    return;
+  }
+
+  boost::thread_group group;
+  for (vector<Chunk>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    group.create_thread(ChunkTask<Step>(&*i));
+  }
+  group.join_all();
+}
+
+class DelimitedText {
+  const char* begin;
+  const char* end;
+  JDelimitedFormat format;
+  int columns;
+  vector<Chunk> chunks;
+
+  void split();
+
+public:
+  DelimitedText(const char* begin, const char* end, const JDelimitedFormat& format);
+
+  int get_columns() const { return columns; }
+  JSize get_rows() const { return chunks.empty() ? 0 : chunks.back().first_row + chunks.back().rows; }
+  ColumnShape shape(int column) const;
+  void parse(const vector<ColumnSink>& sinks);
+};
+
+DelimitedText::DelimitedText(const char* begin, const char* end, const JDelimitedFormat& format):
+  begin(begin), end(end), format(format), columns(0), chunks() {
+  const char* first(begin);
+  while (first < end && trim_line(first, line_end(first, end)) == first) {
+    first = line_end(first, end) + 1;
+  }
+  if (first >= end) return;
+
+  columns = count_fields(first, trim_line(first, line_end(first, end)), format.delimiter);
+  if (format.header) first = line_end(first, end) + 1;
+  this->begin = std::min(first, end);
+
+  split();
+  run_chunks<&Chunk::scan>(chunks);
+
+  JSize rows(0);
+  for (vector<Chunk>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    if (i->ragged) throw JIllegalDimensionsException("Rows have differing numbers of fields");
+    i->first_row = rows;
+    rows += i->rows;
+  }
+}
+
+void DelimitedText::split() {
+  std::size_t bytes(end - begin);
+  std::size_t threads(format.threads > 0 ? format.threads : boost::thread::hardware_concurrency());
+  threads = std::max<std::size_t>(1, std::min(threads, format.threads > 0 ? bytes : bytes / min_chunk_bytes));
+
+  const char* from(begin);
+  for (std::size_t i = 1; i <= threads && from < end; ++i) {
+    const char* to(i == threads ? end : std::max(from, begin + bytes * i / threads));
+    if (to != end) to = std::min(end, line_end(to, end) + 1);
+    chunks.push_back(Chunk(from, to, format.delimiter, columns));
+    from = to;
+  }
+}
+
+ColumnShape DelimitedText::shape(int column) const {
+  ColumnShape res;
+  for (vector<Chunk>::const_iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    res.merge(i->shapes[column]);
+  }
+  return res;
+}
+
+void DelimitedText::parse(const vector<ColumnSink>& sinks) {
+  for (vector<Chunk>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    i->sinks = &sinks;
+  }
+  run_chunks<&Chunk::parse>(chunks);
+  for (vector<Chunk>::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+    if (!i->error.empty()) throw JIllegalSyntaxException(i->error);
+  }
+}
+
+template <typename T>
+char* allocate_column(const Dimensions& d, JNoun::Ptr* res) {
+  intrusive_ptr<JArray<T> > arr(allocated_array<T>(d));
+  *res = arr;
+  return reinterpret_cast<char*>(arr->begin());
+}
+
+char* allocate_payload(j_value_type type, const Dimensions& d, JNoun::Ptr* res) {
+  switch (type) {
+  case j_value_type_int:
+    return allocate_column<JInt>(d, res);
+  case j_value_type_int64:
+    return allocate_column<JInt64>(d, res);
+  default:
+    return allocate_column<JFloat>(d, res);
+  }
+}
+
+std::size_t element_size(j_value_type type) {
+  return type == j_value_type_int ? sizeof(JInt) : sizeof(JInt64);
+}
+
+vector<JNoun::Ptr> parse_delimited_columns(const char* begin, const char* end,
+					   const JDelimitedFormat& format) {
+  DelimitedText text(begin, end, format);
+  vector<JNoun::Ptr> res(text.get_columns());
+  vector<ColumnSink> sinks;
+  for (int i = 0; i < text.get_columns(); ++i) {
+    j_value_type type(text.shape(i).value_type());
+    char* base(allocate_payload(type, Dimensions(1, text.get_rows()), &res[i]));
+    sinks.push_back(ColumnSink(type, base, element_size(type)));
+  }
+  text.parse(sinks);
+  return res;
+}
+
+JNoun::Ptr parse_delimited_table(const char* begin, const char* end, const JDelimitedFormat& format) {
+  DelimitedText text(begin, end, format);
+  ColumnShape widest;
+  for (int i = 0; i < text.get_columns(); ++i) {
+    widest.merge(text.shape(i));
+  }
+
+  JNoun::Ptr res;
+  j_value_type type(widest.value_type());
+  char* base(allocate_payload(type, Dimensions(2, text.get_rows(), JSize(text.get_columns())), &res));
+  vector<ColumnSink> sinks;
+  for (int i = 0; i < text.get_columns(); ++i) {
+    sinks.push_back(ColumnSink(type, base + i * element_size(type), text.get_columns() * element_size(type)));
+  }
+  text.parse(sinks);
+  return res;
+}
+
+class MappedText {
+  const char* data;
+  std::size_t bytes;
+
+  MappedText(const MappedText&);
+  MappedText& operator=(const MappedText&);
+
+public:
+  MappedText(const string& path): data(0), bytes(0) {
+    int fd(open(path.c_str(), O_RDONLY));
+    if (fd < 0) throw JFileException("Failed to open " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw JFileException("Failed to read " + path);
+    }
+    bytes = st.st_size;
+    if (bytes > 0) {
+      void* mapped(mmap(0, bytes, PROT_READ, MAP_PRIVATE, fd, 0));
+      if (mapped == MAP_FAILED) {
+	close(fd);
+	throw JFileException("Failed to map " + path);
+      }
+      data = static_cast<const char*>(mapped);
+      madvise(mapped, bytes, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+
+  ~MappedText() {
+    if (data) munmap(const_cast<char*>(data), bytes);
+  }
+
+  const char* begin() const { return data; }
+  const char* end() const { return data + bytes; }
+};
+
+vector<JNoun::Ptr> load_delimited_columns(const string& path, const JDelimitedFormat& format) {
+  MappedText text(path);
+  return parse_delimited_columns(text.begin(), text.end(), format);
+}
+
+JNoun::Ptr load_delimited_table(const string& path, const JDelimitedFormat& format) {
+  MappedText text(path);
+  return parse_delimited_table(text.begin(), text.end(), format);
+}
+
+string path_argument(const JNoun& arg) {
+  if (arg.get_value_type() != j_value_type_char || arg.get_rank() > 1) {
+    throw JIllegalValueTypeException();
+  }
+  const JArray<JChar>& chars(static_cast<const JArray<JChar>&>(arg));
+  return string(chars.begin(), chars.end());
+}
+
+LoadDelimitedVerb::LoadDelimitedVerb():
+  JVerb(DefaultMonad<MonadOp>::Instantiate(1, MonadOp()),
+	DefaultDyad<DyadOp>::Instantiate(0, 1, DyadOp())) {}
+
+JNoun::Ptr LoadDelimitedVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  return load_delimited_table(path_argument(arg));
+}
+
+JNoun::Ptr LoadDelimitedVerb::DyadOp::operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const {
+  if (larg.get_value_type() != j_value_type_char || !larg.is_scalar()) throw JIllegalValueTypeException();
+  JChar delimiter(static_cast<const JArray<JChar>&>(larg).get_scalar_value());
+  return load_delimited_table(path_argument(rarg), JDelimitedFormat(delimiter));
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef JDELIMITED_HPP
+#define JDELIMITED_HPP
+
+#include "JNoun.hpp"
+#include "JVerbs.hpp"
+#include <string>
+
+namespace J {
+using std::string;
+
+struct JDelimitedFormat {
+  char delimiter;
+  bool header;
+  int threads;
+
+  // threads == 0 uses one thread per core for files large enough to be worth splitting.
+  JDelimitedFormat(char delimiter = ',', bool header = false, int threads = 0):
+    delimiter(delimiter), header(header), threads(threads) {}
+};
+
+// Numeric delimited text is split at line boundaries and parsed in parallel straight into
+// the result. A column is int if every field is a short integer, int64 if some integer
+// needs more than 9 digits and float otherwise; a table takes the widest column type.
+vector<JNoun::Ptr> parse_delimited_columns(const char* begin, const char* end,
+					   const JDelimitedFormat& format = JDelimitedFormat());
+JNoun::Ptr parse_delimited_table(const char* begin, const char* end,
+				 const JDelimitedFormat& format = JDelimitedFormat());
+
+vector<JNoun::Ptr> load_delimited_columns(const string& path,
+					  const JDelimitedFormat& format = JDelimitedFormat());
+JNoun::Ptr load_delimited_table(const string& path, const JDelimitedFormat& format = JDelimitedFormat());
+
+// 1!:50. Monadically loads the comma separated file named by a char list as a table;
+// dyadically the left argument is the delimiter.
+class LoadDelimitedVerb: public JVerb {
+  struct MonadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const;
+  };
+
+  struct DyadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const;
+  };
+
+public:
+  LoadDelimitedVerb();
+};
+
+}
+
+#endif
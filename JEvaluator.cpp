@@ -21,9 +21,9 @@ bool JRuleMonad0::transform(list<JTokenBase::Ptr>* lst, list<JTokenBase::Ptr>::i
   JVerb::Ptr verb(get_word<JVerb>(*iter, get_machine()));
   JNoun::Ptr noun(get_word<JNoun>(*++iter, get_machine()));
   ++iter;
-  JNoun::Ptr res((*verb)(get_machine(), *noun));
-    
   lst->erase(saved_iter, iter);
+
+  JNoun::Ptr res(verb->apply_owned(get_machine(), noun));
   lst->insert(iter, JTokenWord<JNoun>::Instantiate(res));
   return true;
 }
@@ -34,10 +34,9 @@ bool JRuleMonad1::transform(list<JTokenBase::Ptr>* lst, list<JTokenBase::Ptr>::i
   JVerb::Ptr verb(get_word<JVerb>(*iter, get_machine()));
   JNoun::Ptr noun(get_word<JNoun>(*++iter, get_machine()));
   ++iter;
-    
-  JNoun::Ptr res((*verb)(get_machine(), *noun));
-    
   lst->erase(saved_iter, iter);
+    
+  JNoun::Ptr res(verb->apply_owned(get_machine(), noun));
   lst->insert(iter, JTokenWord<JNoun>::Instantiate(res));
   return true;
 }
@@ -51,9 +50,9 @@ bool JRuleDyad2::transform(list<JTokenBase::Ptr>* lst, list<JTokenBase::Ptr>::it
   JVerb::Ptr verb(get_word<JVerb>(*++iter, get_machine()));
   JNoun::Ptr noun1(get_word<JNoun>(*++iter, get_machine()));
   ++iter;
-
-  JNoun::Ptr res((*verb)(get_machine(), *noun0, *noun1));
   lst->erase(saved_iter, iter);
+
+  JNoun::Ptr res(verb->apply_owned(get_machine(), noun0, noun1));
   lst->insert(iter, JTokenWord<JNoun>::Instantiate(res));
   return true;
 }
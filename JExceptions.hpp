@@ -66,6 +66,18 @@ public:
     JException(msg, "JParserException") {}
 };
   
+class JSerializationException: public JException {
+public:
+  JSerializationException(string msg = "Malformed serialized noun"):
+    JException(msg, "JSerializationException") {}
+};
+
+class JFileException: public JException {
+public:
+  JFileException(string msg = "File operation failed"):
+    JException(msg, "JFileException") {}
+};
+
 class JUnimplementedOperationException: public JException {
 public:
   JUnimplementedOperationException(string msg = "Unimplemented operation"): 
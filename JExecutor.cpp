@@ -27,6 +27,7 @@ JExecutor::token_sequence JExecutor::parse_line(const string& line) const {
 
 JWord::Ptr JExecutor::operator()(const string& line) {
   token_sequence seq(parse_line(line));
+  JArena arena;
   
   return J::JEvaluator::big_eval_loop(jmachine, seq->rbegin(), seq->rend());
 }
@@ -4,6 +4,7 @@
 #include "JParser.hpp"
 #include "JEvaluator.hpp"
 #include "JMachine.hpp"
+#include "JArena.hpp"
 
 namespace J {
 
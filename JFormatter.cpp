@@ -0,0 +1,74 @@
+#include "JFormatter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace J {
+
+void format_noun(std::ostream& os, const JNoun& noun, const JFormatOptions& options) {
+  JOutputSink out(os);
+  noun.format(out, options);
+}
+
+std::size_t format_integer(char* out, JInt64 value) {
+  char digits[max_number_chars];
+  char* p(digits + sizeof(digits));
+  boost::uint64_t magnitude(value < 0 ? -static_cast<boost::uint64_t>(value) : value);
+  do {
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  if (value < 0) *--p = '-';
+
+  std::size_t length(digits + sizeof(digits) - p);
+  std::memcpy(out, p, length);
+  return length;
+}
+
+std::size_t format_float(char* out, JFloat value) {
+  if (value == std::floor(value) && std::fabs(value) < 1e15) {
+    return format_integer(out, static_cast<JInt64>(value));
+  }
+  if (value != value || value - value != 0) {
+    return std::sprintf(out, "%g", value);
+  }
+
+  // Values that are short decimals, as most parsed data is, are found by scaling: the
+  // division is correctly rounded, so it reproduces what strtod would read back.
+  JFloat magnitude(std::fabs(value));
+  if (magnitude >= 1e-4 && magnitude < 1e15) {
+    static const JFloat powers[] = { 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8 };
+    for (int decimals = 1; decimals <= 8; ++decimals) {
+      JFloat scaled(std::floor(magnitude * powers[decimals - 1] + 0.5));
+      if (scaled >= 9007199254740992.0) break;
+      if (scaled / powers[decimals - 1] == magnitude) {
+	char digits[max_number_chars];
+	std::size_t length(format_integer(digits, static_cast<JInt64>(scaled)));
+	char* p(out);
+	if (value < 0) *p++ = '-';
+	if (length <= static_cast<std::size_t>(decimals)) {
+	  *p++ = '0';
+	  *p++ = '.';
+	  std::fill(p, p + (decimals - length), '0');
+	  p += decimals - length;
+	  p = std::copy(digits, digits + length, p);
+	} else {
+	  p = std::copy(digits, digits + length - decimals, p);
+	  *p++ = '.';
+	  p = std::copy(digits + length - decimals, digits + length, p);
+	}
+	return p - out;
+      }
+    }
+  }
+
+  int length(0);
+  for (int precision = 15; precision <= 17; ++precision) {
+    length = std::sprintf(out, "%.*g", precision, value);
+    if (std::strtod(out, 0) == value) break;
+  }
+  return length;
+}
+
+}
@@ -0,0 +1,175 @@
+#ifndef JFORMATTER_HPP
+#define JFORMATTER_HPP
+
+#include "JNoun.hpp"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace J {
+using std::string;
+using std::vector;
+
+class JOutputSink {
+  std::ostream& os;
+  vector<char> buffer;
+  std::size_t used;
+
+  JOutputSink(const JOutputSink&);
+  JOutputSink& operator=(const JOutputSink&);
+
+public:
+  static const std::size_t buffer_size = 64 * 1024;
+
+  explicit JOutputSink(std::ostream& os): os(os), buffer(buffer_size), used(0) {}
+  ~JOutputSink() { flush(); }
+
+  void put(char c) {
+    if (used == buffer_size) flush();
+    buffer[used++] = c;
+  }
+
+  void fill(char c, std::size_t n) {
+    for (; n > 0; --n) put(c);
+  }
+
+  void write(const char* data, std::size_t n) {
+    if (used + n > buffer_size) {
+      flush();
+      if (n > buffer_size) {
+	os.write(data, n);
+	return;
+      }
+    }
+    std::memcpy(&buffer[used], data, n);
+    used += n;
+  }
+
+  void flush() {
+    os.write(&buffer[0], used);
+    used = 0;
+  }
+};
+
+// Zero means unlimited; truncated rows and columns are replaced by "...".
+struct JFormatOptions {
+  JSize max_rows;
+  JSize max_columns;
+
+  JFormatOptions(JSize max_rows = 0, JSize max_columns = 0):
+    max_rows(max_rows), max_columns(max_columns) {}
+};
+
+void format_noun(std::ostream& os, const JNoun& noun, const JFormatOptions& options = JFormatOptions());
+
+const std::size_t max_number_chars = 32;
+
+std::size_t format_integer(char* out, JInt64 value);
+// The shortest representation that reads back as the same double.
+std::size_t format_float(char* out, JFloat value);
+
+inline void format_element(string& arena, JInt64 value) {
+  char digits[max_number_chars];
+  arena.append(digits, format_integer(digits, value));
+}
+
+inline void format_element(string& arena, JBool value) {
+  arena += value ? '1' : '0';
+}
+
+inline void format_element(string& arena, JChar value) {
+  arena += value;
+}
+
+inline void format_element(string& arena, JInt8 value) {
+  format_element(arena, static_cast<JInt64>(value));
+}
+
+inline void format_element(string& arena, JInt16 value) {
+  format_element(arena, static_cast<JInt64>(value));
+}
+
+inline void format_element(string& arena, JInt value) {
+  format_element(arena, static_cast<JInt64>(value));
+}
+
+inline void format_element(string& arena, JFloat value) {
+  char digits[max_number_chars];
+  arena.append(digits, format_float(digits, value));
+}
+
+inline void format_element(string& arena, const JComplex& value) {
+  arena += '(';
+  format_element(arena, value.real());
+  arena += ',';
+  format_element(arena, value.imag());
+  arena += ')';
+}
+
+inline void format_element(string& arena, const JBox& value) {
+  arena += "JBox[";
+  arena += value.get_contents()->to_string();
+  arena += ']';
+}
+
+// Only the displayed elements are formatted, once, into an arena; the widest of them
+// sets the field width. Boxes span several lines and are not padded.
+template <typename T>
+void format_array(JOutputSink& out, const JArray<T>& arr, const JFormatOptions& options) {
+  const Dimensions& d(arr.get_dims());
+  int rank(d.get_rank());
+  typename JArray<T>::iter base(arr.begin());
+
+  if (rank == 0) {
+    string cell;
+    format_element(cell, T(*base));
+    out.write(cell.data(), cell.size());
+    return;
+  }
+
+  JSize columns(d[rank - 1]), rows(1);
+  for (int i = 0; i < rank - 1; ++i) rows *= d[i];
+  JSize shown_rows(options.max_rows > 0 ? std::min(rows, options.max_rows) : rows);
+  JSize shown_columns(options.max_columns > 0 ? std::min(columns, options.max_columns) : columns);
+
+  string arena;
+  vector<std::size_t> ends;
+  ends.reserve(shown_rows * shown_columns + 1);
+  ends.push_back(0);
+  std::size_t width(0);
+  for (JSize r = 0; r < shown_rows; ++r) {
+    typename JArray<T>::iter row(base + r * columns);
+    for (JSize c = 0; c < shown_columns; ++c) {
+      format_element(arena, T(row[c]));
+      width = std::max(width, arena.size() - ends.back());
+      ends.push_back(arena.size());
+    }
+  }
+  if (JTypeTrait<T>::value_type == j_value_type_box) width = 0;
+
+  vector<std::size_t>::const_iterator end(ends.begin());
+  for (JSize r = 0; r < shown_rows; ++r) {
+    for (JSize c = 0; c < shown_columns; ++c, ++end) {
+      std::size_t length(end[1] - end[0]);
+      if (length < width) out.fill(' ', width - length);
+      out.write(arena.data() + end[0], length);
+      out.put(' ');
+    }
+    if (shown_columns < columns) out.write("... ", 4);
+
+    if (rank > 1) {
+      out.put('\n');
+      JSize span(1);
+      for (int axis = rank - 2; axis > 0; --axis) {
+	span *= d[axis];
+	if ((r + 1) % span == 0) out.put('\n');
+      }
+    }
+  }
+  if (shown_rows < rows) out.write("...\n", 4);
+}
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "JFusion.hpp"
+#include "JTypes.hpp"
+#include <algorithm>
+
+namespace J {
+
+namespace {
+
+struct BitSame { JBitWord operator()(JBitWord a) const { return a; } };
+
+template <typename T>
+struct AllocateResult {
+  JNoun::Ptr operator()(const Dimensions& d) const {
+    return allocated_array<T>(d);
+  }
+};
+
+template <typename T>
+struct StoreBlock {
+  void operator()(const JArray<T>& block, const JNoun::Ptr& res, const JSize& first) const {
+    std::copy(block.begin(), block.end(), static_cast<const JArray<T>&>(*res).begin() + first);
+  }
+};
+
+template <>
+struct StoreBlock<JBool> {
+  void operator()(const JArray<JBool>& block, const JNoun::Ptr& res, const JSize& first) const {
+    transform_bits(block.begin(), block.end(), static_cast<const JArray<JBool>&>(*res).begin() + first,
+		   BitSame());
+  }
+};
+
+// Collects the blocks of a result in one array. A block that comes out wider than those
+// before it, as when an integer sum overflows, widens what has been stored so far.
+class BlockResult {
+  Dimensions dims;
+  JNoun::Ptr res;
+
+public:
+  explicit BlockResult(const Dimensions& dims): dims(dims) {}
+
+  bool store(JNoun::Ptr block, JSize first, JSize length) {
+    if (block->get_rank() != 1 || block->get_dims()[0] != length) return false;
+
+    if (!res) {
+      res = JTypeDispatcher<AllocateResult, JNoun::Ptr>()(block->get_value_type(), dims);
+    } else if (block->get_value_type() != res->get_value_type()) {
+      optional<j_value_type> type(TypeConversions::get_instance()
+				  ->find_best_type_conversion(res->get_value_type(),
+							      block->get_value_type()));
+      if (!type) return false;
+      if (*type != res->get_value_type()) res = GetNounAsJArrayOfType()(*res, *type);
+      if (*type != block->get_value_type()) block = GetNounAsJArrayOfType()(*block, *type);
+    }
+
+    JArrayCaller<StoreBlock, void>()(*block, res, first);
+    return true;
+  }
+
+  JNoun::Ptr get() const { return res; }
+};
+
+JNoun::Ptr block_of(const JNoun& arg, JSize first, JSize length) {
+  return arg.is_scalar() ? arg.view(arg.get_dims(), 0) : arg.view(Dimensions(1, length), first);
+}
+
+}
+
+JNoun::Ptr blockwise_apply(const Monad& monad, JMachine::Ptr m, const JNoun& arg) {
+  JSize n(arg.get_dims().number_of_elems());
+  if (n <= fusion_block_size) return JNoun::Ptr();
+
+  BlockResult res(arg.get_dims());
+  for (JSize first = 0; first < n; first += fusion_block_size) {
+    JSize length(std::min(fusion_block_size, n - first));
+    if (!res.store(monad.apply_owned(m, block_of(arg, first, length)), first, length)) {
+      return JNoun::Ptr();
+    }
+  }
+  return res.get();
+}
+
+JNoun::Ptr blockwise_apply(const Dyad& dyad, JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) {
+  if (!larg.is_scalar() && !rarg.is_scalar() && larg.get_dims() != rarg.get_dims()) {
+    return JNoun::Ptr();
+  }
+  const Dimensions& dims(larg.is_scalar() ? rarg.get_dims() : larg.get_dims());
+  JSize n(dims.number_of_elems());
+  if (n <= fusion_block_size) return JNoun::Ptr();
+
+  BlockResult res(dims);
+  for (JSize first = 0; first < n; first += fusion_block_size) {
+    JSize length(std::min(fusion_block_size, n - first));
+    if (!res.store(dyad.apply_owned(m, block_of(larg, first, length), block_of(rarg, first, length)),
+		   first, length)) {
+      return JNoun::Ptr();
+    }
+  }
+  return res.get();
+}
+
+}
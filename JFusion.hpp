@@ -0,0 +1,22 @@
+#ifndef JFUSION_HPP
+#define JFUSION_HPP
+
+#include "JNoun.hpp"
+#include "JVerbs.hpp"
+
+namespace J {
+
+// Verbs made only of elementwise verbs are run over the argument a block at a time, so the
+// intermediate nouns of every stage stay in cache and are reused from one stage to the
+// next instead of each spanning the whole argument.
+const JSize fusion_block_size = 4096;
+
+// Both return a null pointer when the argument fits in one block or, for the dyad, when
+// neither argument is a scalar and their shapes differ; the caller then applies the verb
+// as a whole.
+JNoun::Ptr blockwise_apply(const Monad& monad, JMachine::Ptr m, const JNoun& arg);
+JNoun::Ptr blockwise_apply(const Dyad& dyad, JMachine::Ptr m, const JNoun& larg, const JNoun& rarg);
+
+}
+
+#endif
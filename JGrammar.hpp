@@ -4,7 +4,9 @@
 #include <climits>
 #include <complex>
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <string>
+#include "JRefCounted.hpp"
 
 namespace J {
 using std::string;
@@ -19,39 +21,63 @@ enum j_grammar_class {
 };
 
 enum j_value_type {
+  j_value_type_bool,
+  j_value_type_int8,
+  j_value_type_int16,
   j_value_type_int, 
+  j_value_type_int64,
   j_value_type_float,
   j_value_type_complex,
   j_value_type_char, 
   j_value_type_box
 };
   
+typedef bool JBool;
+typedef signed char JInt8;
+typedef short JInt16;
 typedef int JInt;
+typedef boost::int64_t JInt64;
 typedef double JFloat;
 typedef std::complex<JFloat> JComplex;
 typedef char JChar;
 
-class JNoun;
-class JBox {
-  shared_ptr<JNoun> contents;
-public:
-  JBox(shared_ptr<JNoun> contents): contents(contents) { assert(contents); }
-  
-  bool operator==(const JBox& box) const;
-  shared_ptr<JNoun> get_contents() const { return contents; } ;
-};
+class JBox;
 
 std::ostream& operator<<(std::ostream& os, const JBox& b);
 
 template <typename T> 
 class JTypeTrait {};
   
+template <>
+struct JTypeTrait<JBool> {
+  static JBool base_elem() { return false; }
+  static const j_value_type value_type = j_value_type_bool;
+};
+
+template <>
+struct JTypeTrait<JInt8> {
+  static JInt8 base_elem() { return 0; }
+  static const j_value_type value_type = j_value_type_int8;
+};
+
+template <>
+struct JTypeTrait<JInt16> {
+  static JInt16 base_elem() { return 0; }
+  static const j_value_type value_type = j_value_type_int16;
+};
+
 template <>
 struct JTypeTrait<JInt> {
   static JInt base_elem() { return 0; }
   static const j_value_type value_type = j_value_type_int;
 };
 
+template <>
+struct JTypeTrait<JInt64> {
+  static JInt64 base_elem() { return 0; }
+  static const j_value_type value_type = j_value_type_int64;
+};
+
 template <>
 struct JTypeTrait<JChar> {
   static JChar base_elem() { return ' '; }
@@ -76,10 +102,10 @@ struct JTypeTrait<JBox> {
   static const j_value_type value_type = j_value_type_box;
 };
 
-class JWord { 
-  j_grammar_class grammar_class;
+class JWord: public JRefCounted<JWord> { 
+  unsigned char grammar_class;
 public:
-  typedef shared_ptr<JWord> Ptr;
+  typedef JRef<JWord> Ptr;
 
   virtual ~JWord() {};
   virtual string to_string() const = 0;
@@ -90,7 +116,9 @@ public:
     return !(*this == word);
   }
   JWord(j_grammar_class grammar_class): grammar_class(grammar_class) {}
-  j_grammar_class get_grammar_class() const { return grammar_class; }
+  // Words that own other counted objects publish those along with themselves.
+  virtual void publish() const { JRefCounted<JWord>::publish(); }
+  j_grammar_class get_grammar_class() const { return static_cast<j_grammar_class>(grammar_class); }
 };
 
 
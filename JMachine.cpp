@@ -13,10 +13,13 @@ JMachine::JMachine(): operators(), cur_locale(Locale::Instantiate()) {
   operators.insert(p("i.", JWord::Ptr(new IDotVerb())));
   operators.insert(p("/", JWord::Ptr(new JInsertTableAdverb())));
   operators.insert(p("\"", JWord::Ptr(new RankConjunction())));
+  operators.insert(p("!:", JWord::Ptr(new ForeignConjunction())));
   operators.insert(p("\\", JWord::Ptr(new PrefixInfixAdverb())));
   operators.insert(p("$", JWord::Ptr(new ShapeVerb())));
   operators.insert(p(",", JWord::Ptr(new RavelAppendVerb())));
   operators.insert(p(";", JWord::Ptr(new RazeLinkVerb())));
+  operators.insert(p("|:", JWord::Ptr(new TransposeVerb())));
+  operators.insert(p("|.", JWord::Ptr(new ReverseRotateVerb())));
   operators.insert(p("*", JWord::Ptr(new SignumTimesVerb())));
   operators.insert(p("%", JWord::Ptr(new ReciprocalDivideVerb())));
   operators.insert(p("<", JWord::Ptr(new LessBoxVerb())));
@@ -25,6 +28,9 @@ JMachine::JMachine(): operators(), cur_locale(Locale::Instantiate()) {
   operators.insert(p(">.", JWord::Ptr(new CeilingGreaterofVerb())));
   operators.insert(p("<:", JWord::Ptr(new DecrementLessequalVerb())));
   operators.insert(p(">:", JWord::Ptr(new IncrementMoreequalVerb())));
+  operators.insert(p("+.", JWord::Ptr(new GcdOrVerb())));
+  operators.insert(p("*.", JWord::Ptr(new LcmAndVerb())));
+  operators.insert(p("-.", JWord::Ptr(new NotVerb())));
 }
 
 JMachine::Ptr JMachine::new_machine() { 
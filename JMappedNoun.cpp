@@ -0,0 +1,90 @@
+#include "JMappedNoun.hpp"
+#include "JSerialize.hpp"
+#include "JExceptions.hpp"
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace J {
+
+class Unmap {
+  std::size_t bytes;
+
+public:
+  Unmap(std::size_t bytes): bytes(bytes) {}
+  void operator()(void* data) const { munmap(data, bytes); }
+};
+
+JMappedNoun::JMappedNoun(const string& path, map_mode mode): path(path), mode(mode), noun() {
+  remap();
+}
+
+void JMappedNoun::remap() {
+  int fd(open(path.c_str(), O_RDONLY));
+  if (fd < 0) throw JFileException("Failed to open " + path);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    throw JFileException("Failed to map " + path);
+  }
+
+  bool private_copy(mode == map_mode_copy_on_write);
+  std::size_t bytes(st.st_size);
+  void* data(mmap(0, bytes, private_copy ? PROT_READ | PROT_WRITE : PROT_READ,
+		  private_copy ? MAP_PRIVATE : MAP_SHARED, fd, 0));
+  close(fd);
+  if (data == MAP_FAILED) throw JFileException("Failed to map " + path);
+
+  shared_ptr<void> region(data, Unmap(bytes));
+  noun = decode_noun(static_cast<const char*>(data), bytes, region, private_copy);
+}
+
+void JMappedNoun::create(const string& path, const JNoun& noun) {
+  std::ofstream os(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os) throw JFileException("Failed to create " + path);
+  encode_noun(os, noun);
+}
+
+void JMappedNoun::append(const JNoun& items) {
+  if (mode != map_mode_append) throw JFileException(path + " is not mapped for appending");
+
+  j_value_type type(noun->get_value_type());
+  if (type == j_value_type_bool || type == j_value_type_box) {
+    throw JUnimplementedOperationException();
+  }
+  if (items.get_value_type() != type) throw JIllegalValueTypeException();
+  if (noun->get_rank() == 0) throw JIllegalRankException();
+
+  Dimensions item(noun->get_dims().suffix(-1));
+  JSize count;
+  if (items.get_dims() == item) {
+    count = 1;
+  } else if (items.get_rank() == noun->get_rank() && items.get_dims().suffix(-1) == item) {
+    count = items.get_dims()[0];
+  } else {
+    throw JIllegalDimensionsException();
+  }
+
+  std::fstream fs(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (!fs) throw JFileException("Failed to open " + path);
+
+  Dimensions grown(Dimensions(1, noun->get_dims()[0] + count) + item);
+  std::streamoff payload(16 + 8 * noun->get_rank());
+  std::streamoff end(payload + payload_bytes(type, grown.number_of_elems()));
+  fs.seekp(payload + payload_bytes(type, noun->get_dims().number_of_elems()));
+  encode_payload(fs, items);
+  fs.seekp(end);
+  fs.write("\0\0\0\0\0\0\0", (8 - end % 8) % 8);
+  fs.seekp(8);
+  encode_header(fs, type, grown);
+  fs.flush();
+  if (!fs) throw JFileException("Failed to append to " + path);
+  fs.close();
+
+  remap();
+}
+
+}
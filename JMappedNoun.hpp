@@ -0,0 +1,53 @@
+#ifndef JMAPPEDNOUN_HPP
+#define JMAPPEDNOUN_HPP
+
+#include "JNoun.hpp"
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+namespace J {
+using std::string;
+using boost::shared_ptr;
+
+enum map_mode {
+  map_mode_read_only,
+  map_mode_copy_on_write,
+  map_mode_append
+};
+
+// A noun whose payloads live in a file in the serialized format, mapped into memory
+// rather than read. Read-only and append mappings are shared with every other process
+// mapping the file; copy-on-write mappings are private and may be updated in place.
+class JMappedNoun {
+public:
+  typedef shared_ptr<JMappedNoun> Ptr;
+
+private:
+  string path;
+  map_mode mode;
+  JNoun::Ptr noun;
+
+  JMappedNoun(const string& path, map_mode mode);
+  JMappedNoun(const JMappedNoun&);
+  JMappedNoun& operator=(const JMappedNoun&);
+
+  void remap();
+
+public:
+  static Ptr Instantiate(const string& path, map_mode mode = map_mode_read_only) {
+    return Ptr(new JMappedNoun(path, mode));
+  }
+
+  static void create(const string& path, const JNoun& noun);
+
+  map_mode get_mode() const { return mode; }
+  JNoun::Ptr get_noun() const { return noun; }
+
+  // Appends items along the leading axis of the file and remaps it. Nouns obtained
+  // before the append are unaffected.
+  void append(const JNoun& items);
+};
+
+}
+
+#endif
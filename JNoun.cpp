@@ -1,84 +1,304 @@
 #include "JNoun.hpp"
+#include "JRagged.hpp"
 #include "utils.hpp"
+#include "JTypes.hpp"
+#include "JFormatter.hpp"
+#include <boost/thread/once.hpp>
 
 namespace J {
 
 JNoun::JNoun(const Dimensions& d, j_value_type value_type): 
   JWord(grammar_class_noun), value_type(value_type), dims(d) {}
 
+JNoun::Ptr JNoun::coordinate(JSize i, JSize j) const {
+  vector<JSize> coords;
+  coords.push_back(i);
+  coords.push_back(j);
+  return coordinate(coords);
+}
+
+JNoun::Ptr JNoun::coordinate(JSize i, JSize j, JSize k) const {
+  vector<JSize> coords;
+  coords.push_back(i);
+  coords.push_back(j);
+  coords.push_back(k);
+  return coordinate(coords);
+}
+
 template <typename T>
-JArray<T>::JArray(const Dimensions& d, shared_ptr<container> v):
-  JNoun(d, JTypeTrait<T>::value_type), content(v), 
-  begin_iter(content->begin()), end_iter(content->end()) {
-  assert(static_cast<unsigned>(d.number_of_elems()) == v->size());
+JArray<T>::JArray(const Dimensions& d, container_ptr v):
+  JNoun(d, JTypeTrait<T>::value_type), content(v), offset(0), cell(JTypeTrait<T>::base_elem()) {
+  assert(static_cast<std::size_t>(d.number_of_elems()) == v->get_size());
 }
   
 template <typename T>
-JArray<T>::JArray(const Dimensions& d, shared_ptr<container> v, iter begin, iter end):
-  JNoun(d, JTypeTrait<T>::value_type), content(v), 
-  begin_iter(begin), end_iter(end) {
-  assert(d.number_of_elems() == distance(begin, end));
+JArray<T>::JArray(const Dimensions& d, container_ptr v, std::size_t offset):
+  JNoun(d, JTypeTrait<T>::value_type), content(v), offset(offset), 
+  cell(JTypeTrait<T>::base_elem()) {
+  assert(offset + d.number_of_elems() <= v->get_size());
+}
+
+template <typename T>
+JArray<T>::JArray(const Dimensions& d, shared_ptr<vector<T> > v):
+  JNoun(d, JTypeTrait<T>::value_type), content(container::InstantiateCopy(v->begin(), v->end())),
+  offset(0), cell(JTypeTrait<T>::base_elem()) {
+  assert(static_cast<std::size_t>(d.number_of_elems()) == v->size());
 }
   
 template <typename T>
-JArray<T>::JArray(const Dimensions& d, const JArray<T>& arr, iter begin, iter end):
+JArray<T>::JArray(const Dimensions& d, const JArray<T>& arr, iter begin):
   JNoun(d, JTypeTrait<T>::value_type), content(arr.content), 
-  begin_iter(begin), end_iter(end) {
-  assert(d.number_of_elems() == distance(begin, end));
+  offset(begin - arr.content->begin()), cell(JTypeTrait<T>::base_elem()) {
+  assert(offset + d.number_of_elems() <= content->get_size());
 }
   
 template <typename T>
-JArray<T>::JArray(): 
-  JNoun(Dimensions(), JTypeTrait<T>::value_type), content(new container(0, JTypeTrait<T>::base_elem())),
-  begin_iter(content->begin()), end_iter(content->end()) {
+JArray<T>::JArray(const Dimensions& d, const JProgression& progression):
+  JNoun(d, JTypeTrait<T>::value_type), content(), offset(0), 
+  representation(new Representation(progression)), 
+  cell(JTypeTrait<T>::base_elem()) {}
+
+bool is_row_major(const Dimensions& d, const vector<JSize>& strides) {
+  vector<JSize> expected(row_major_strides(d));
+  for (int i = 0; i < d.get_rank(); ++i) {
+    if (d[i] != 1 && strides[i] != expected[i]) return false;
+  }
+  return true;
+}
+
+template <typename T>
+JArray<T>::JArray(const Dimensions& d, container_ptr source, std::size_t offset, 
+		  const vector<JSize>& strides):
+  JNoun(d, JTypeTrait<T>::value_type), content(), offset(0), representation(),
+  cell(JTypeTrait<T>::base_elem()) {
+  assert(static_cast<int>(strides.size()) == d.get_rank());
+  if (d.number_of_elems() == 0) {
+    content = container::Instantiate(0);
+  } else if (is_row_major(d, strides)) {
+    content = source;
+    this->offset = offset;
+  } else {
+    representation.reset(new Representation(Strided(source, offset, strides)));
+  }
+}
+
+template <typename T>
+JArray<T>::JArray(const Dimensions& d, shared_ptr<const JRagged> table, JSize first):
+  JNoun(d, JTypeTrait<T>::value_type), content(), offset(0), 
+  representation(new Representation(Ragged(table, first))), cell(JTypeTrait<T>::base_elem()) {
+  assert(first + d.number_of_elems() <= static_cast<JSize>(table->shapes.size()));
 }
+
+template <typename T>
+JArray<T>::JArray(T value): 
+  JNoun(Dimensions(), JTypeTrait<T>::value_type), content(), offset(0), cell(value) {}
+
+template <typename T>
+JArray<T>::JArray(): 
+  JNoun(Dimensions(), JTypeTrait<T>::value_type), content(), offset(0), cell(JTypeTrait<T>::base_elem()) {}
   
+template <typename T>
+struct VarargType {
+  typedef T type;
+};
+
+template <> struct VarargType<JBool> { typedef int type; };
+template <> struct VarargType<JInt8> { typedef int type; };
+template <> struct VarargType<JInt16> { typedef int type; };
+template <> struct VarargType<JChar> { typedef int type; };
+
 template <typename T>
 JArray<T>::JArray(const Dimensions &d, ...): 
-  JNoun(d, JTypeTrait<T>::value_type), content(new container(d.number_of_elems(), JTypeTrait<T>::base_elem())),
-  begin_iter(content->begin()), end_iter(content->end()) 
+  JNoun(d, JTypeTrait<T>::value_type), 
+  content(d.get_rank() == 0 ? container_ptr() : container::Instantiate(d.number_of_elems())), 
+  offset(0), cell(JTypeTrait<T>::base_elem())
 {
   va_list va;
   va_start(va, d);
     
-  for (iter i = begin_iter; i != end_iter; ++i) {
-    *i = va_arg(va, T);
+  for (iter i = begin(), e = end(); i != e; ++i) {
+    *i = static_cast<T>(va_arg(va, typename VarargType<T>::type));
   }
 
   va_end(va);
 }
   
 template <>
-JArray<JBox>::JArray(const Dimensions &d, ...): JNoun(d, j_value_type_box) {
+JArray<JBox>::JArray(const Dimensions &d, ...): 
+  JNoun(d, j_value_type_box), cell(JTypeTrait<JBox>::base_elem()) {
   throw std::logic_error("THis method must no be called with jbox");
 }
 
+template <typename T>
+T progression_value(JInt64 val) {
+  return static_cast<T>(val);
+}
+
 template <>
-JArray<JChar>::JArray(const Dimensions &d, ...): 
-  JNoun(d, JTypeTrait<JChar>::value_type), 
-  content(new container(d.number_of_elems(), JTypeTrait<JChar>::base_elem())),
-  begin_iter(content->begin()), end_iter(content->end()) 
-{
-  va_list va;
-  va_start(va, d);
-    
-  for (iter i = begin_iter; i != end_iter; ++i) {
-    *i = static_cast<JChar>(va_arg(va, int));
+JBox progression_value<JBox>(JInt64) {
+  throw std::logic_error("Boxes can not be arithmetic progressions");
+}
+
+template <typename T>
+T ragged_value(const JRagged&, JSize) {
+  throw std::logic_error("Only boxes can have a ragged layout");
+}
+
+template <>
+JBox ragged_value<JBox>(const JRagged& table, JSize n) {
+  return JBox(table.contents(n));
+}
+
+template <typename Iterator>
+void gather_strided(Iterator source, const Dimensions& dims, const vector<JSize>& strides, 
+		    Iterator out) {
+  int rank(dims.get_rank());
+  if (rank == 0) {
+    *out = *source;
+    return;
   }
 
-  va_end(va);
+  JSize inner(dims[rank - 1]), inner_stride(strides[rank - 1]);
+  vector<JSize> index(rank, 0);
+  JSize pos(0);
+  for (JSize done = 0, n = dims.number_of_elems(); done < n; done += inner) {
+    Iterator row(source + pos);
+    for (JSize i = 0; i < inner; ++i, ++out) {
+      *out = row[i * inner_stride];
+    }
+
+    for (int axis = rank - 2; axis >= 0; --axis) {
+      pos += strides[axis];
+      if (++index[axis] < dims[axis]) break;
+      pos -= strides[axis] * dims[axis];
+      index[axis] = 0;
+    }
+  }
+}
+
+template <typename T>
+void JArray<T>::materialise() const {
+  container_ptr dense(container::Instantiate(get_dims().number_of_elems()));
+
+  if (progression()) {
+    JSize n = 0;
+    for (iterator i = dense->begin(), e = dense->end(); i != e; ++i, ++n) {
+      *i = progression_value<T>(progression()->at(n));
+    }
+  } else if (ragged()) {
+    JSize n = ragged()->first;
+    for (iterator i = dense->begin(), e = dense->end(); i != e; ++i, ++n) {
+      *i = ragged_value<T>(*ragged()->table, n);
+    }
+  } else {
+    assert(strided());
+    gather_strided(strided()->source->begin() + strided()->offset, get_dims(), strided()->strides, 
+		   dense->begin());
+  }
+  assert(!is_published());
+  content = dense;
+}
+
+template <typename T>
+void JArray<T>::publish_buffer(const container& buffer) {
+  buffer.publish();
+}
+
+template <>
+void JArray<JBox>::publish_buffer(const container& buffer) {
+  buffer.publish();
+  for (const JBox* box = buffer.begin(); box != buffer.end(); ++box) {
+    box->get_contents()->publish();
+  }
+}
+
+// A published noun is read by several threads, so its lazy views are made dense first
+// and nothing is written to it afterwards.
+template <typename T>
+void JArray<T>::publish() const {
+  if (representation && !content) materialise();
+  JNoun::publish();
+  if (content) publish_buffer(*content);
+  if (representation) {
+    representation->publish();
+    if (strided()) publish_buffer(*strided()->source);
+    if (ragged()) ragged()->table->payload->publish();
+  }
+}
+
+template <typename T>
+typename JArray<T>::container_ptr JArray<T>::get_content() const {
+  if (is_inline()) {
+    container_ptr single(container::InstantiateCopy(begin(), begin() + 1));
+    if (is_published()) return single;
+    content = single;
+  }
+  begin();
+  return content;
+}
+
+template <typename T>
+typename JArray<T>::Strided JArray<T>::layout() const {
+  if (strided() && !content) return *strided();
+  return Strided(get_content(), offset, row_major_strides(get_dims()));
+}
+
+bool strided_block(const Dimensions& dims, const vector<JSize>& strides, const Dimensions& block,
+		   JSize first, std::size_t* offset, vector<JSize>* block_strides) {
+  int rank(dims.get_rank());
+  if (block.get_rank() > rank || dims.number_of_elems() == 0) return false;
+
+  Dimensions inner(block.suffix(-1));
+  if (!dims.suffix_match(inner) || first % inner.number_of_elems() != 0) return false;
+
+  int axis(rank - block.get_rank());
+  JSize index(first / inner.number_of_elems()), delta(0);
+  for (int i = block.get_rank() == 0 ? rank - 1 : axis; i >= 0; --i) {
+    JSize coord(index % dims[i]);
+    index /= dims[i];
+    if (i == axis && coord + block[0] > dims[i]) return false;
+    delta += coord * strides[i];
+  }
+
+  *offset += delta;
+  block_strides->assign(strides.begin() + axis, strides.end());
+  return true;
+}
+
+template <typename T>
+JArray<T> JArray<T>::slice(const Dimensions& d, JSize first) const {
+  assert(first >= 0 && first + d.number_of_elems() <= get_dims().number_of_elems());
+  if (is_inline() && d.get_rank() == 0) {
+    return *this;
+  } else if (strided() && !content) {
+    std::size_t view_offset(strided()->offset);
+    vector<JSize> view_strides;
+    if (strided_block(get_dims(), strided()->strides, d, first, &view_offset, &view_strides)) {
+      return JArray<T>(d, strided()->source, view_offset, view_strides);
+    }
+  } else if (ragged() && !content) {
+    return JArray<T>(d, ragged()->table, ragged()->first + first);
+  } else if (progression() && !content) {
+    return JArray<T>(d, JProgression(progression()->at(first), progression()->step));
+  }
+
+  JArray<T> res(d, get_content(), offset + first);
+  if (progression()) {
+    res.representation.reset(new Representation(JProgression(progression()->at(first), 
+							      progression()->step)));
+  } else if (ragged()) {
+    res.representation.reset(new Representation(Ragged(ragged()->table, ragged()->first + first)));
+  }
+  return res;
 }
 
 template <typename T> 
-JArray<T> JArray<T>::operator[](int n) const {
+JArray<T> JArray<T>::operator[](JSize n) const {
   assert(get_rank() > 0);
   assert(n >= 0 && n < get_dims()[0]);
   Dimensions suffix = get_dims().suffix(-1);
     
-  int nr_of_elems = suffix.number_of_elems();
-  iter beg = begin() + n * nr_of_elems;
-    
-  return JArray<T>(suffix, content, beg, beg + nr_of_elems);
+  return slice(suffix, n * suffix.number_of_elems());
 }
   
 template <typename T> 
@@ -86,7 +306,7 @@ void JArray<T>::extend_into(const Dimensions& d, iter new_ptr) const {
   if (d.number_of_elems() == 0) return;
   
   if ((get_rank() == 1 || get_rank() == 0) || get_dims() == d) {
-    copy(begin(), end(), new_ptr);
+    std::copy(begin(), end(), new_ptr);
   } else {
     iter old_ptr(begin()), old_end(end());
     
@@ -94,8 +314,8 @@ void JArray<T>::extend_into(const Dimensions& d, iter new_ptr) const {
     VectorCounter vc2(d);
     
     while (old_ptr != old_end) {
-      pair<int, int> p(add_row(vc1, vc2));
-      copy(old_ptr, old_ptr + p.first, new_ptr);
+      pair<JSize, JSize> p(add_row(vc1, vc2));
+      std::copy(old_ptr, old_ptr + p.first, new_ptr);
       old_ptr += p.first;
       new_ptr += p.second;
     }
@@ -108,10 +328,10 @@ JNoun::Ptr JArray<T>::extend(const Dimensions &d) const {
     
   if (d == get_dims()) return clone();
     
-  shared_ptr<container> nv(new container(d.number_of_elems(), JTypeTrait<T>::base_elem()));
+  container_ptr nv(container::InstantiateFilled(d.number_of_elems(), JTypeTrait<T>::base_elem()));
     
   if (get_rank() == 1) {
-    copy(begin(), end(), nv->begin());
+    std::copy(begin(), end(), nv->begin());
   } else {
     iter old_ptr = begin(), new_ptr = nv->begin(), new_end = nv->end();
       
@@ -119,8 +339,8 @@ JNoun::Ptr JArray<T>::extend(const Dimensions &d) const {
     VectorCounter vc2(d);
       
     while (new_ptr != new_end) {
-      pair<int, int> p(add_row(vc1, vc2));
-      copy(old_ptr, old_ptr + p.first, new_ptr);
+      pair<JSize, JSize> p(add_row(vc1, vc2));
+      std::copy(old_ptr, old_ptr + p.first, new_ptr);
       old_ptr += p.first;
       new_ptr += p.second;
     }
@@ -139,49 +359,29 @@ string JArray<T>::to_string() const {
 template <typename T> 
 string JArray<T>::content_string() const { 
   std::stringstream ss;
-  content_string(ss, get_field_width());
+  format_noun(ss, *this);
   return ss.str();
 }
-    
-template <typename T> 
-void JArray<T>::content_string(std::stringstream &ss, int field_width) const {
-  if (get_rank() == 0) {
-    ss << std::setw(field_width) << std::setfill(' ') << *begin();
-  } else if (get_rank() == 1) {
-    for (iter p = begin(); p != end(); ++p) {
-      ss << std::setw(field_width) << std::setfill(' ') << (*p) << " ";
-    }
-  } else {
-    for (int i = 0; i < get_dims()[0]; ++i) {
-      (*this)[i].content_string(ss, field_width);
-      ss << std::endl;
-    }
-  }
+
+template <typename T>
+void JArray<T>::format(JOutputSink& out, const JFormatOptions& options) const {
+  format_array(out, *this, options);
 }
 
 template <typename T>
-JNoun::Ptr JArray<T>::coordinate(int coord_nr, ...) const {
-  assert(get_rank() >= coord_nr);
-  assert(coord_nr >= 0);
+JNoun::Ptr JArray<T>::coordinate(const vector<JSize>& coords) const {
+  assert(get_rank() >= static_cast<int>(coords.size()));
     
-  va_list va;
-  va_start(va, coord_nr);
-    
-  int offset = 0, i = 0;
-  for(; i < coord_nr; ++i) {
+  JSize offset = 0;
+  int i = 0;
+  for(; i < static_cast<int>(coords.size()); ++i) {
     offset *= get_dims()[i];
-    int coord = va_arg(va, int);
-    assert(coord >= 0 && coord < get_dims()[i]);
-    offset += coord;
+    assert(coords[i] >= 0 && coords[i] < get_dims()[i]);
+    offset += coords[i];
   }
-  va_end(va);
 
   Dimensions suffix = get_dims().suffix(-i);
-  int suffix_len = suffix.number_of_elems();
-  iter ptr = begin() + offset * suffix_len;
-  assert(distance(ptr, end()) >= 0);
-    
-  return JNoun::Ptr(new JArray<T>(suffix, content, ptr, ptr + suffix_len));
+  return JNoun::Ptr(new JArray<T>(slice(suffix, offset * suffix.number_of_elems())));
 }
 
 template <typename T>
@@ -189,34 +389,56 @@ JNoun::Ptr JArray<T>::clone() const {
   return JNoun::Ptr(new JArray<T>(*this));
 }
 
-template <typename T> 
-shared_ptr<typename JArray<T>::container> JArray<T>::get_content() const { 
-  return content; 
+template <typename T>
+JNoun::Ptr JArray<T>::transpose(const vector<int>& axes) const {
+  assert(static_cast<int>(axes.size()) == get_rank());
+  Strided from(layout());
+
+  vector<JSize> dims(axes.size()), strides(axes.size());
+  for (std::size_t i = 0; i < axes.size(); ++i) {
+    dims[i] = get_dims()[axes[i]];
+    strides[i] = from.strides[axes[i]];
+  }
+  return JNoun::Ptr(new JArray<T>(Dimensions::from_range(dims.begin(), dims.end()), 
+				  from.source, from.offset, strides));
 }
 
-template <>
-shared_ptr<JArray<JBox>::container> JArray<JBox>::get_content() const { 
-  return shared_ptr<JArray<JBox>::container>(new JArray<JBox>::container(begin(), end()));
+template <typename T>
+JNoun::Ptr JArray<T>::reverse() const {
+  if (get_rank() == 0 || get_dims()[0] <= 1) return clone();
+
+  JSize last(get_dims()[0] - 1);
+  if (progression() && get_rank() == 1) {
+    return JNoun::Ptr(new JArray<T>(get_dims(), JProgression(progression()->at(last), -progression()->step)));
+  }
+
+  Strided from(layout());
+  from.offset += last * from.strides[0];
+  from.strides[0] = -from.strides[0];
+  return JNoun::Ptr(new JArray<T>(get_dims(), from.source, from.offset, from.strides));
 }
-   
+
+template <typename T>
+JNoun::Ptr JArray<T>::view(const Dimensions& d, JSize first) const {
+  return JNoun::Ptr(new JArray<T>(slice(d, first)));
+}
+
 template <typename T>
-JNoun::Ptr JArray<T>::subarray(int start, int end) const { 
+JNoun::Ptr JArray<T>::subarray(JSize start, JSize end) const { 
   assert(start >= 0 && end >= 0);
   assert(end >= start);
 
   Dimensions suffix(get_dims().suffix(-1));
-  int nr_of_elems = suffix.number_of_elems();
+  JSize nr_of_elems = suffix.number_of_elems();
   
   Dimensions new_dims(Dimensions(1, end - start) + suffix);
-  int first_dim = get_dims()[0];
+  JSize first_dim = get_dims()[0];
   if (start <= first_dim && end <= first_dim) {
-    return JNoun::Ptr(new JArray<T>(new_dims, *this, 
-				    begin() + (start * nr_of_elems),
-				    begin() + (end * nr_of_elems)));
+    return JNoun::Ptr(new JArray<T>(slice(new_dims, start * nr_of_elems)));
   } else { 
-    shared_ptr<vector<T> > v(new vector<T>(new_dims.number_of_elems(), JTypeTrait<T>::base_elem()));
+    container_ptr v(container::InstantiateFilled(new_dims.number_of_elems(), JTypeTrait<T>::base_elem()));
     if (start < first_dim) {
-      v->insert(v->begin(), begin() + (start * nr_of_elems), this->end());
+      std::copy(begin() + (start * nr_of_elems), this->end(), v->begin());
     }
     return JNoun::Ptr(new JArray<T>(new_dims, v));
   }
@@ -224,30 +446,112 @@ JNoun::Ptr JArray<T>::subarray(int start, int end) const {
     
 template <typename T>
 bool JArray<T>::operator==(const JWord& other) const {
+  if (other.get_grammar_class() != get_grammar_class()) return false;
+  
+  const JNoun& noun(static_cast<const JNoun&>(other));
+  if (noun.get_value_type() != get_value_type()) {
+    if (compares_by_value(get_value_type(), noun.get_value_type())) {
+      return *GetNounAsJArrayOfType()(*this, noun.get_value_type()) == noun;
+    }
+    return compares_by_value(noun.get_value_type(), get_value_type()) && noun == *this;
+  }
+  
   return 
-    other.get_grammar_class() == get_grammar_class() &&
-    static_cast<const JNoun&>(other).get_value_type() == get_value_type() &&
-    get_dims() == static_cast<const JNoun&>(other).get_dims() &&
-    equal(begin(), end(), static_cast< const JArray<T>& >(other).begin());
+    get_dims() == noun.get_dims() &&
+    std::equal(begin(), end(), static_cast< const JArray<T>& >(other).begin());
 }
 
-template <typename T>
-int JArray<T>::get_field_width() const { 
-  return 0;
+vector<JSize> row_major_strides(const Dimensions& d) {
+  vector<JSize> strides(d.get_rank());
+  JSize stride(1);
+  for (int i = d.get_rank() - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= d[i];
+  }
+  return strides;
+}
+
+const JInt cached_int_min = -16;
+const JInt cached_int_max = 255;
+
+// Common scalars are shared by every thread, so they are all made once, under
+// call_once, and published before any thread can see them.
+struct ScalarCache {
+  JNoun::Ptr ints[cached_int_max - cached_int_min + 1];
+  JNoun::Ptr bools[2];
+  JNoun::Ptr float_zero, float_one;
+
+  ScalarCache() {
+    for (JInt value = cached_int_min; value <= cached_int_max; ++value) {
+      ints[value - cached_int_min] = published(new JArray<JInt>(value));
+    }
+    bools[0] = published(new JArray<JBool>(false));
+    bools[1] = published(new JArray<JBool>(true));
+    float_zero = published(new JArray<JFloat>(0.0));
+    float_one = published(new JArray<JFloat>(1.0));
+  }
+
+  static JNoun::Ptr published(JNoun* noun) {
+    JNoun::Ptr res(noun);
+    res->publish();
+    return res;
+  }
+};
+
+static ScalarCache* scalar_cache(0);
+static boost::once_flag scalar_cache_once = BOOST_ONCE_INIT;
+
+static void build_scalar_cache() {
+  scalar_cache = new ScalarCache();
+}
+
+static const ScalarCache& get_scalar_cache() {
+  boost::call_once(&build_scalar_cache, scalar_cache_once);
+  return *scalar_cache;
 }
 
 template <>
-int JArray<JInt>::get_field_width() const {
-  iter max = std::max_element(begin(), end());
-  iter min = std::min_element(begin(), end());
-    
-  int max_len = max != end() && *max > 0 ? std::floor(std::log10(*max)) + 1 : 1;
-  int min_len = min != end() && *min < 0 ? std::floor(std::log10(std::abs(*min))) + 2 : 1;
-    
-  return std::max(max_len, min_len);
+JNoun::Ptr scalar_noun<JInt>(JInt value) {
+  if (value < cached_int_min || value > cached_int_max) {
+    return JNoun::Ptr(new JArray<JInt>(value));
+  }
+  return get_scalar_cache().ints[value - cached_int_min];
+}
+
+template <>
+JNoun::Ptr scalar_noun<JBool>(JBool value) {
+  return get_scalar_cache().bools[value ? 1 : 0];
+}
+
+template <>
+JNoun::Ptr scalar_noun<JFloat>(JFloat value) {
+  if (value == 1.0) return get_scalar_cache().float_one;
+  if (value == 0.0 && 1.0 / value > 0) return get_scalar_cache().float_zero;
+  return JNoun::Ptr(new JArray<JFloat>(value));
+}
+
+JNoun::Ptr progression_array(const Dimensions& dims, const JProgression& progression, j_value_type type) {
+  switch (type) {
+  case j_value_type_int8:
+    return JNoun::Ptr(new JArray<JInt8>(dims, progression));
+  case j_value_type_int16:
+    return JNoun::Ptr(new JArray<JInt16>(dims, progression));
+  case j_value_type_int:
+    return JNoun::Ptr(new JArray<JInt>(dims, progression));
+  case j_value_type_int64:
+    return JNoun::Ptr(new JArray<JInt64>(dims, progression));
+  case j_value_type_float:
+    return JNoun::Ptr(new JArray<JFloat>(dims, progression));
+  default:
+    throw std::logic_error("Progressions must be of an integer or float type");
+  }
 }
 
+template class JArray<JBool>;
+template class JArray<JInt8>;
+template class JArray<JInt16>;
 template class JArray<JInt>;
+template class JArray<JInt64>;
 template class JArray<JFloat>;
 template class JArray<JBox>;
 template class JArray<JChar>;
@@ -3,6 +3,7 @@
 
 #include "JGrammar.hpp"
 #include "Dimensions.hpp"
+#include "JBuffer.hpp"
 
 #include <stdexcept>
 #include <iomanip>
@@ -15,55 +16,139 @@ namespace J {
 using boost::optional;
 using std::pair;
 
+struct JProgression {
+  JInt64 start, step;
+
+  JProgression(JInt64 start, JInt64 step): start(start), step(step) {}
+  JInt64 at(JSize n) const { return start + n * step; }
+};
+
+template <typename T>
+struct InlineCell {
+  typedef T type;
+  static T* begin(T& cell) { return &cell; }
+};
+
+template <>
+struct InlineCell<JBool> {
+  typedef JBitWord type;
+  static JBitIterator begin(JBitWord& cell) { return JBitIterator(&cell, 0); }
+};
+
+struct JRagged;
+class JOutputSink;
+struct JFormatOptions;
+
 class JNoun: public JWord {
 public:
-  typedef shared_ptr<JNoun> Ptr;
+  typedef JRef<JNoun> Ptr;
 
 private:
-  j_value_type value_type;
+  unsigned char value_type;
   Dimensions dims;
 
 public:
   JNoun(const Dimensions& d, j_value_type value_type);
   virtual string to_string() const = 0;
-  virtual JNoun::Ptr subarray(int start, int end) const = 0;
-  virtual JNoun::Ptr coordinate(int nr_coords, ...) const = 0;
+  virtual void format(JOutputSink& out, const JFormatOptions& options) const = 0;
+  virtual JNoun::Ptr subarray(JSize start, JSize end) const = 0;
+  virtual JNoun::Ptr coordinate(const vector<JSize>& coords) const = 0;
+  JNoun::Ptr coordinate(JSize i) const { return coordinate(vector<JSize>(1, i)); }
+  JNoun::Ptr coordinate(JSize i, JSize j) const;
+  JNoun::Ptr coordinate(JSize i, JSize j, JSize k) const;
   virtual JNoun::Ptr clone() const = 0;
+  virtual JNoun::Ptr transpose(const vector<int>& axes) const = 0;
+  virtual JNoun::Ptr reverse() const = 0;
+  virtual JNoun::Ptr view(const Dimensions& d, JSize first) const = 0;
 
   virtual JNoun::Ptr extend(const Dimensions &d) const = 0;
+  virtual bool has_unique_content() const = 0;
+  virtual optional<JProgression> get_progression() const = 0;
   bool is_scalar() const { return get_rank() == 0; }
   bool is_array() const { return !is_scalar(); }
     
   int get_rank() const { return get_dims().get_rank(); }
-  j_value_type get_value_type() const { return value_type; }
+  j_value_type get_value_type() const { return static_cast<j_value_type>(value_type); }
   const Dimensions& get_dims() const { return dims; } 
 };
+
+class JBox {
+  JNoun::Ptr contents;
+public:
+  JBox(JNoun::Ptr contents): contents(contents) { assert(contents); }
+  
+  bool operator==(const JBox& box) const;
+  JNoun::Ptr get_contents() const { return contents; } ;
+};
   
 template <typename T> 
 class JArray: public JNoun {
 public:
-  typedef vector<T> container;
+  typedef JBuffer<T> container;
+  typedef typename container::Ptr container_ptr;
   typedef typename container::iterator iter;
   typedef typename container::iterator iterator;
 
 private:
-  shared_ptr<container> content;
-
-  iter begin_iter;
-  iter end_iter;
+  struct Strided {
+    container_ptr source;
+    std::size_t offset;
+    vector<JSize> strides;
+
+    Strided(container_ptr source, std::size_t offset, const vector<JSize>& strides):
+      source(source), offset(offset), strides(strides) {}
+  };
+
+  struct Ragged {
+    shared_ptr<const JRagged> table;
+    JSize first;
+
+    Ragged(shared_ptr<const JRagged> table, JSize first): table(table), first(first) {}
+  };
+
+  struct Representation: public JRefCounted<Representation> {
+    optional<JProgression> progression;
+    optional<Strided> strided;
+    optional<Ragged> ragged;
+
+    explicit Representation(const JProgression& progression): progression(progression) {}
+    explicit Representation(const Strided& strided): strided(strided) {}
+    explicit Representation(const Ragged& ragged): ragged(ragged) {}
+  };
+
+  mutable container_ptr content;
+  std::size_t offset;
+  JRef<Representation> representation;
+  mutable typename InlineCell<T>::type cell;
+
+  const JProgression* progression() const { 
+    return representation ? representation->progression.get_ptr() : 0; 
+  }
+  const Strided* strided() const { return representation ? representation->strided.get_ptr() : 0; }
+  const Ragged* ragged() const { return representation ? representation->ragged.get_ptr() : 0; }
 
-  int get_field_width() const;
-  void content_string(std::stringstream &s, int field_width) const;
+  bool is_inline() const { return !content && !representation; }
+  Strided layout() const;
+  void materialise() const;
+  static void publish_buffer(const container& buffer);
     
 public:
-  JArray(const Dimensions& d, shared_ptr<container> v);
-  JArray(const Dimensions& d, shared_ptr<container> v, iter begin, iter end);
-  JArray(const Dimensions& d, const JArray<T>& arr, iter begin, iter end);
+  JArray(const Dimensions& d, container_ptr v);
+  JArray(const Dimensions& d, container_ptr v, std::size_t offset);
+  JArray(const Dimensions& d, shared_ptr<vector<T> > v);
+  JArray(const Dimensions& d, const JArray<T>& arr, iter begin);
+  JArray(const Dimensions& d, const JProgression& progression);
+  JArray(const Dimensions& d, container_ptr source, std::size_t offset, const vector<JSize>& strides);
+  JArray(const Dimensions& d, shared_ptr<const JRagged> table, JSize first);
   JArray(const Dimensions &d, ...);
+  explicit JArray(T value);
   JArray();
 
-  JArray<T> operator[](int n) const;
-  JNoun::Ptr coordinate(int nr_coords, ...) const;
+  JArray<T> operator[](JSize n) const;
+  using JNoun::coordinate;
+  JNoun::Ptr coordinate(const vector<JSize>& coords) const;
+  void publish() const;
+  JArray<T> slice(const Dimensions& d, JSize first) const;
     
 
   bool operator==(const JWord& j) const;
@@ -73,25 +158,75 @@ public:
 
   string to_string() const;
   string content_string() const;
+  void format(JOutputSink& out, const JFormatOptions& options) const;
 
   JNoun::Ptr clone() const;
-  JNoun::Ptr subarray(int start, int end) const;
+  JNoun::Ptr transpose(const vector<int>& axes) const;
+  JNoun::Ptr reverse() const;
+  JNoun::Ptr view(const Dimensions& d, JSize first) const;
+  JNoun::Ptr subarray(JSize start, JSize end) const;
   JNoun::Ptr extend(const Dimensions &d) const;
   void extend_into(const Dimensions& d, iter new_begin) const;
-  shared_ptr<container> get_content() const;
+  container_ptr get_content() const;
+  std::size_t get_offset() const { return offset; }
+  bool has_unique_content() const { 
+    return content && !representation && content->is_unique() && content->is_writable(); 
+  }
+  optional<JProgression> get_progression() const { 
+    return progression() ? optional<JProgression>(*progression()) : optional<JProgression>(); 
+  }
+  bool is_strided() const { return strided() != 0; }
+  shared_ptr<const JRagged> get_ragged() const { 
+    return ragged() ? ragged()->table : shared_ptr<const JRagged>(); 
+  }
+  JSize get_ragged_first() const { return ragged() ? ragged()->first : 0; }
 
   T get_scalar_value() const { assert(is_scalar()); return *begin(); }
-  iter begin() const { return begin_iter; }
-  iter end() const { return end_iter; }
+  iter begin() const { 
+    if (!content) {
+      if (is_inline()) return InlineCell<T>::begin(cell);
+      materialise();
+    }
+    return content->begin() + offset; 
+  }
+  iter end() const { return begin() + get_dims().number_of_elems(); }
 };
 
 
+vector<JSize> row_major_strides(const Dimensions& d);
+JNoun::Ptr progression_array(const Dimensions& dims, const JProgression& progression, j_value_type type);
+
+template <typename T>
+intrusive_ptr<JArray<T> > filled_array(const Dimensions &dims, T val) {
+  if (dims.get_rank() == 0) return intrusive_ptr<JArray<T> >(new JArray<T>(val));
+  return intrusive_ptr<JArray<T> >(new JArray<T>(dims, JBuffer<T>::InstantiateFilled(dims.number_of_elems(), val)));
+}
+
 template <typename T>
-shared_ptr<JArray<T> > filled_array(const Dimensions &dims, T val) {
-  shared_ptr<vector<T> > v(new vector<T>(dims.number_of_elems(), val));
-  return shared_ptr<JArray<T> >(new JArray<T>(dims, v));
+intrusive_ptr<JArray<T> > allocated_array(const Dimensions &dims) {
+  if (dims.get_rank() == 0) return intrusive_ptr<JArray<T> >(new JArray<T>(JTypeTrait<T>::base_elem()));
+  return intrusive_ptr<JArray<T> >(new JArray<T>(dims, JBuffer<T>::Instantiate(dims.number_of_elems())));
 }
 
+template <typename T>
+intrusive_ptr<JArray<T> > external_array(const Dimensions &dims, const T* data, shared_ptr<void> owner,
+					 bool writable = false) {
+  // Arena buffers are moved when their sentence ends, which would leave data dangling.
+  assert(!JArena::holds(data));
+  typename JBuffer<T>::Ptr payload(JBuffer<T>::InstantiateExternal(data, dims.number_of_elems(), owner,
+								   writable));
+  return intrusive_ptr<JArray<T> >(new JArray<T>(dims, payload));
+}
+
+template <typename T>
+JNoun::Ptr scalar_noun(T value) {
+  return JNoun::Ptr(new JArray<T>(value));
+}
+
+template <> JNoun::Ptr scalar_noun<JBool>(JBool value);
+template <> JNoun::Ptr scalar_noun<JInt>(JInt value);
+template <> JNoun::Ptr scalar_noun<JFloat>(JFloat value);
+
 
 }
 
@@ -48,15 +48,15 @@ Res parse_number(Iterator begin, Iterator end, Res base) {
 }
 
 template <typename Iterator>
-class IntegerParser: public Parser<Iterator, JInt>  { 
+class IntegerParser: public Parser<Iterator, JInt64>  { 
   RegexParser<Iterator> parser; 
 
 public:
   IntegerParser(): parser("(_?)(\\d+)") {}
-  JInt parse(Iterator* begin, Iterator end) const { 
+  JInt64 parse(Iterator* begin, Iterator end) const { 
     shared_ptr<vector<string> > v(parser.parse(begin, end));
-    JInt sign = (((*v)[1]) == "_") ? (-1) : 1;
-    return sign * parse_number<string::iterator, JInt>((*v)[2].begin(), (*v)[2].end(), 10);
+    JInt64 sign = (((*v)[1]) == "_") ? (-1) : 1;
+    return sign * parse_number<string::iterator, JInt64>((*v)[2].begin(), (*v)[2].end(), 10);
   }
 };
 
@@ -73,7 +73,11 @@ public:
   
 public:
   ParsedNumberBase::Ptr parse(Iterator *begin, Iterator end) const {
-    return ParsedNumberBase::Ptr(new ParsedNumber<JInt>(parser.parse(begin, end)));
+    JInt64 nr(parser.parse(begin, end));
+    if (narrowest_int_type(nr, nr) == j_value_type_int64) {
+      return ParsedNumberBase::Ptr(new ParsedNumber<JInt64>(nr));
+    }
+    return ParsedNumberBase::Ptr(new ParsedNumber<JInt>(static_cast<JInt>(nr)));
   }
 };
     
@@ -264,6 +268,7 @@ public:
   OperatorParser(T begin, T end): parser() {
     vector<string> v(distance(begin, end));
     transform(begin, end, v.begin(), ptr_fun(&J::escape_regex));
+    std::stable_sort(v.begin(), v.end(), longer_string);
     string s(join_str(v.begin(), v.end(), "|"));
     parser = shared_ptr<RegexParser<Iterator> >(new RegexParser<Iterator>(join_str(v.begin(), v.end(), "|")));
   }
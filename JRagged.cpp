@@ -0,0 +1,109 @@
+#include "JRagged.hpp"
+#include <algorithm>
+
+namespace J {
+
+JRagged::JRagged(JNoun::Ptr payload, const vector<JSize>& offsets, const vector<Dimensions>& shapes):
+  payload(payload), offsets(offsets), shapes(shapes) {
+  assert(offsets.size() == shapes.size() + 1);
+  assert(payload->get_dims().number_of_elems() == offsets.back());
+}
+
+template <typename T>
+JNoun::Ptr link_payloads(const JArray<T>& head, const JNoun& rarg) {
+  vector<JSize> offsets(1, 0);
+  vector<Dimensions> shapes(1, head.get_dims());
+  offsets.push_back(head.get_dims().number_of_elems());
+
+  const JArray<T>* tail;
+  JSize from(0), to(rarg.get_dims().number_of_elems());
+  if (rarg.get_value_type() == j_value_type_box) {
+    const JArray<JBox>& boxes(static_cast<const JArray<JBox>&>(rarg));
+    const JRagged& table(*boxes.get_ragged());
+    JSize first(boxes.get_ragged_first()), last(first + boxes.get_dims().number_of_elems());
+
+    for (JSize i = first; i < last; ++i) {
+      shapes.push_back(table.shapes[i]);
+      offsets.push_back(offsets.back() + table.offsets[i + 1] - table.offsets[i]);
+    }
+    tail = &static_cast<const JArray<T>&>(*table.payload);
+    from = table.offsets[first];
+    to = table.offsets[last];
+  } else {
+    shapes.push_back(rarg.get_dims());
+    offsets.push_back(offsets.back() + to);
+    tail = &static_cast<const JArray<T>&>(rarg);
+  }
+
+  intrusive_ptr<JArray<T> > payload(allocated_array<T>(Dimensions(1, offsets.back())));
+  std::copy(tail->begin() + from, tail->begin() + to, 
+	    std::copy(head.begin(), head.end(), payload->begin()));
+
+  JRagged::Ptr table(new JRagged(payload, offsets, shapes));
+  return JNoun::Ptr(new JArray<JBox>(Dimensions(1, shapes.size()), table, 0));
+}
+
+JNoun::Ptr flat_link(const JNoun& larg, const JNoun& rarg) {
+  j_value_type type(larg.get_value_type());
+  if (rarg.get_value_type() == j_value_type_box) {
+    const JArray<JBox>& boxes(static_cast<const JArray<JBox>&>(rarg));
+    if (!boxes.get_ragged() || boxes.get_rank() > 1 || 
+	boxes.get_ragged()->payload->get_value_type() != type) {
+      return JNoun::Ptr();
+    }
+  } else if (rarg.get_value_type() != type) {
+    return JNoun::Ptr();
+  }
+
+  switch (type) {
+  case j_value_type_bool:
+    return link_payloads(static_cast<const JArray<JBool>&>(larg), rarg);
+  case j_value_type_int8:
+    return link_payloads(static_cast<const JArray<JInt8>&>(larg), rarg);
+  case j_value_type_int16:
+    return link_payloads(static_cast<const JArray<JInt16>&>(larg), rarg);
+  case j_value_type_int:
+    return link_payloads(static_cast<const JArray<JInt>&>(larg), rarg);
+  case j_value_type_int64:
+    return link_payloads(static_cast<const JArray<JInt64>&>(larg), rarg);
+  case j_value_type_float:
+    return link_payloads(static_cast<const JArray<JFloat>&>(larg), rarg);
+  case j_value_type_complex:
+    return link_payloads(static_cast<const JArray<JComplex>&>(larg), rarg);
+  case j_value_type_char:
+    return link_payloads(static_cast<const JArray<JChar>&>(larg), rarg);
+  default:
+    return JNoun::Ptr();
+  }
+}
+
+JNoun::Ptr flat_raze(const JArray<JBox>& boxes) {
+  JRagged::Ptr table(boxes.get_ragged());
+  JSize first(boxes.get_ragged_first()), last(first + boxes.get_dims().number_of_elems());
+  if (!table || first == last) return JNoun::Ptr();
+
+  Dimensions item(table->shapes[first].suffix(-1));
+  JSize items(0);
+  for (JSize i = first; i < last; ++i) {
+    const Dimensions& shape(table->shapes[i]);
+    if (!(shape.suffix(-1) == item)) return JNoun::Ptr();
+    items += shape.get_rank() == 0 ? 1 : shape[0];
+  }
+
+  return table->payload->view(Dimensions(1, items) + item, table->offsets[first]);
+}
+
+JNoun::Ptr flat_open(const JArray<JBox>& boxes) {
+  JRagged::Ptr table(boxes.get_ragged());
+  JSize first(boxes.get_ragged_first()), last(first + boxes.get_dims().number_of_elems());
+  if (!table || first == last) return JNoun::Ptr();
+
+  const Dimensions& shape(table->shapes[first]);
+  for (JSize i = first + 1; i < last; ++i) {
+    if (!(table->shapes[i] == shape)) return JNoun::Ptr();
+  }
+
+  return table->payload->view(boxes.get_dims() + shape, table->offsets[first]);
+}
+
+}
@@ -0,0 +1,26 @@
+#ifndef JRAGGED_HPP
+#define JRAGGED_HPP
+
+#include "JNoun.hpp"
+
+namespace J {
+
+struct JRagged {
+  typedef shared_ptr<const JRagged> Ptr;
+
+  JNoun::Ptr payload;
+  vector<JSize> offsets;
+  vector<Dimensions> shapes;
+
+  JRagged(JNoun::Ptr payload, const vector<JSize>& offsets, const vector<Dimensions>& shapes);
+
+  JNoun::Ptr contents(JSize n) const { return payload->view(shapes[n], offsets[n]); }
+};
+
+JNoun::Ptr flat_link(const JNoun& larg, const JNoun& rarg);
+JNoun::Ptr flat_raze(const JArray<JBox>& boxes);
+JNoun::Ptr flat_open(const JArray<JBox>& boxes);
+
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "JReductions.hpp"
+#include "VerbHelpers.hpp"
+#include <algorithm>
+
+namespace J {
+
+namespace {
+
+// Each kernel folds b into a, and integer sums and products leave the sign bit of
+// overflow set if they overflow.
+struct Add { template <typename T> static T apply(T a, T b, T&) { return a + b; } };
+struct Multiply { template <typename T> static T apply(T a, T b, T&) { return a * b; } };
+struct Lesser { template <typename T> static T apply(T a, T b, T&) { return std::min(a, b); } };
+struct Greater { template <typename T> static T apply(T a, T b, T&) { return std::max(a, b); } };
+
+template <typename T>
+struct Kernels {
+  typedef Add add;
+  typedef Multiply multiply;
+};
+
+template <>
+struct Kernels<JInt> {
+  typedef CheckedAdd add;
+  typedef CheckedMultiply multiply;
+};
+
+template <>
+struct Kernels<JInt64> {
+  typedef CheckedAdd add;
+  typedef CheckedMultiply multiply;
+};
+
+// acc holds the last row on entry; the earlier rows are folded into it from the right.
+template <typename Kernel, typename T>
+bool fold_rows(simd_op op, const T* rows, JSize count, JSize length, T* acc) {
+  T overflow(0);
+  for (JSize r = count - 1; r-- > 0 && overflow >= 0;) {
+    const T* row(rows + r * length);
+    bool simd_overflow(false);
+    if (simd_checked_transform(op, row, acc, acc, length, simd_overflow)) {
+      if (simd_overflow) return false;
+    } else if (!simd_transform(op, row, acc, acc, length)) {
+      for (JSize i = 0; i < length; ++i) acc[i] = Kernel::apply(row[i], acc[i], overflow);
+    }
+  }
+  return overflow >= 0;
+}
+
+// Eight interleaved folds, so that consecutive elements do not wait on each other.
+template <typename Kernel, typename T>
+bool fold_short(const T* values, JSize n, T& res) {
+  T overflow(0);
+  if (n < 16) {
+    res = values[n - 1];
+    for (JSize i = n - 1; i-- > 0;) res = Kernel::apply(values[i], res, overflow);
+    return overflow >= 0;
+  }
+
+  T acc[8];
+  std::copy(values, values + 8, acc);
+  JSize i(8);
+  for (; i + 8 <= n; i += 8) {
+    for (int k = 0; k < 8; ++k) acc[k] = Kernel::apply(acc[k], values[i + k], overflow);
+  }
+  for (; i < n; ++i) acc[0] = Kernel::apply(acc[0], values[i], overflow);
+  for (int width = 4; width > 0; width /= 2) {
+    for (int k = 0; k < width; ++k) acc[k] = Kernel::apply(acc[k], acc[k + width], overflow);
+  }
+  res = acc[0];
+  return overflow >= 0;
+}
+
+template <typename Kernel, typename T>
+bool fold_vector(simd_op op, const T* values, JSize n, T& res) {
+  if (n < 2 * reduction_lanes) return fold_short<Kernel>(values, n, res);
+
+  JSize rows(n / reduction_lanes), tail(n % reduction_lanes);
+  T acc[reduction_lanes + 1];
+  std::copy(values + (rows - 1) * reduction_lanes, values + rows * reduction_lanes, acc);
+  if (!fold_rows<Kernel>(op, values, rows, reduction_lanes, acc)) return false;
+  if (tail > 0 && !fold_short<Kernel>(values + rows * reduction_lanes, tail, acc[reduction_lanes])) {
+    return false;
+  }
+  return fold_short<Kernel>(acc, tail > 0 ? reduction_lanes + 1 : reduction_lanes, res);
+}
+
+template <typename Kernel, typename T>
+bool fold_cells(simd_op op, const T* values, JSize cells, JSize items, JSize length, T* out) {
+  for (JSize c = 0; c < cells; ++c, values += items * length, out += length) {
+    if (length == 1) {
+      if (!fold_vector<Kernel>(op, values, items, *out)) return false;
+    } else {
+      std::copy(values + (items - 1) * length, values + items * length, out);
+      if (!fold_rows<Kernel>(op, values, items, length, out)) return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool fold_cells(simd_op op, const T* values, JSize cells, JSize items, JSize length, T* out) {
+  switch (op) {
+  case simd_op_add: 
+    return fold_cells<typename Kernels<T>::add>(op, values, cells, items, length, out);
+  case simd_op_multiply:
+    return fold_cells<typename Kernels<T>::multiply>(op, values, cells, items, length, out);
+  case simd_op_lesser:
+    return fold_cells<Lesser>(op, values, cells, items, length, out);
+  case simd_op_greater:
+    return fold_cells<Greater>(op, values, cells, items, length, out);
+  default:
+    return false;
+  }
+}
+
+template <typename T>
+JNoun::Ptr reduce_typed(simd_op op, const JArray<T>& arg, int rank) {
+  Dimensions frame(arg.get_dims().prefix(-rank)), cell(arg.get_dims().suffix(rank));
+  Dimensions item(cell.suffix(-1));
+  const T* values(arg.begin());
+
+  if (frame.get_rank() == 0 && item.get_rank() == 0) {
+    T res;
+    if (!fold_cells(op, values, 1, cell[0], 1, &res)) return JNoun::Ptr();
+    return scalar_noun(res);
+  }
+
+  intrusive_ptr<JArray<T> > res(allocated_array<T>(frame + item));
+  if (!fold_cells(op, values, frame.number_of_elems(), cell[0], item.number_of_elems(), res->begin())) {
+    return JNoun::Ptr();
+  }
+  return res;
+}
+
+// Products and lesser-ofs of booleans are all-ones, greater-ofs any-ones.
+JNoun::Ptr reduce_bits(simd_op op, const JArray<JBool>& arg) {
+  if (arg.get_rank() != 1 || op == simd_op_add) return JNoun::Ptr();
+  JSize n(arg.get_dims()[0]);
+  JSize ones(count_bits(arg.begin(), arg.end()));
+  return scalar_noun<JBool>(op == simd_op_greater ? ones > 0 : ones == n);
+}
+
+}
+
+JNoun::Ptr reduce_items(simd_op op, const JNoun& arg) {
+  return reduce_cells(op, arg, arg.get_rank());
+}
+
+JNoun::Ptr reduce_cells(simd_op op, const JNoun& arg, int rank) {
+  if (rank < 1 || rank > arg.get_rank() || arg.get_dims().number_of_elems() == 0) {
+    return JNoun::Ptr();
+  }
+
+  switch (arg.get_value_type()) {
+  case j_value_type_bool:
+    if (rank != arg.get_rank()) return JNoun::Ptr();
+    return reduce_bits(op, static_cast<const JArray<JBool>&>(arg));
+  case j_value_type_int8:
+  case j_value_type_int16:
+  case j_value_type_int:
+    return reduce_typed(op, require_type<JInt>(arg), rank);
+  case j_value_type_int64:
+    return reduce_typed(op, static_cast<const JArray<JInt64>&>(arg), rank);
+  case j_value_type_float:
+    return reduce_typed(op, static_cast<const JArray<JFloat>&>(arg), rank);
+  default:
+    return JNoun::Ptr();
+  }
+}
+
+}
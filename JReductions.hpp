@@ -0,0 +1,25 @@
+#ifndef JREDUCTIONS_HPP
+#define JREDUCTIONS_HPP
+
+#include "JNoun.hpp"
+#include "JSimd.hpp"
+
+namespace J {
+
+// Folds one of the associative dyads (simd_op_add, simd_op_multiply, simd_op_lesser or
+// simd_op_greater) over the leading axis of arg. Whole items are combined at once with the
+// dyad's vector kernel; a long vector is folded as a table of reduction_lanes columns whose
+// totals are combined at the end.
+const JSize reduction_lanes = 1024;
+
+// Returns a null pointer for bool tables, box and complex arguments, for empty ones and
+// when an integer sum or product overflows, leaving those to the item-by-item fold.
+JNoun::Ptr reduce_items(simd_op op, const JNoun& arg);
+
+// The same fold over each cell of the given rank, as a reduction under the rank
+// conjunction; the results are written straight into one array.
+JNoun::Ptr reduce_cells(simd_op op, const JNoun& arg, int rank);
+
+}
+
+#endif
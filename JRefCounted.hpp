@@ -0,0 +1,58 @@
+#ifndef JREFCOUNTED_HPP
+#define JREFCOUNTED_HPP
+
+#include <boost/intrusive_ptr.hpp>
+
+namespace J {
+using boost::intrusive_ptr;
+
+// Reference counts are plain integers until publish() is called; objects that are
+// handed to other threads must be published first, after which the count is
+// maintained with atomic operations.
+template <typename Derived>
+class JRefCounted {
+  mutable int references;
+  mutable bool published;
+
+protected:
+  JRefCounted(): references(0), published(false) {}
+  JRefCounted(const JRefCounted&): references(0), published(false) {}
+  JRefCounted& operator=(const JRefCounted&) { return *this; }
+  ~JRefCounted() {}
+
+public:
+  void publish() const { published = true; }
+  bool is_published() const { return published; }
+  bool is_unique() const { return references == 1; }
+
+  friend void intrusive_ptr_add_ref(const JRefCounted* p) {
+    if (p->published) {
+      __sync_add_and_fetch(&p->references, 1);
+    } else {
+      ++p->references;
+    }
+  }
+
+  friend void intrusive_ptr_release(const JRefCounted* p) {
+    int remaining(p->published ? __sync_sub_and_fetch(&p->references, 1) : --p->references);
+    if (remaining == 0) {
+      delete static_cast<const Derived*>(p);
+    }
+  }
+};
+
+// Unlike intrusive_ptr, adopting a raw pointer has to be explicit, so that a literal 0
+// never silently converts into a null reference.
+template <typename T>
+class JRef: public intrusive_ptr<T> {
+public:
+  JRef() {}
+  explicit JRef(T* p): intrusive_ptr<T>(p) {}
+
+  template <typename U>
+  JRef(const intrusive_ptr<U>& p): intrusive_ptr<T>(p) {}
+};
+
+}
+
+#endif
@@ -0,0 +1,442 @@
+#include "JSerialize.hpp"
+#include "JExceptions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace J {
+
+const std::size_t serialization_header_bytes = 8;
+const boost::uint32_t serialization_max_rank = 1 << 16;
+const std::size_t serialization_chunk_bytes = 1024 * 1024;
+
+template <typename T>
+struct WireTraits {
+  static std::size_t unit() { return sizeof(T); }
+};
+
+template <>
+struct WireTraits<JComplex> {
+  static std::size_t unit() { return sizeof(JFloat); }
+};
+
+inline bool little_endian_host() {
+  const JBitWord one(1);
+  return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+inline std::size_t padding(std::size_t bytes) {
+  return (8 - bytes % 8) % 8;
+}
+
+void swap_units(char* data, std::size_t count, std::size_t unit) {
+  for (std::size_t i = 0; i < count; ++i) {
+    std::reverse(data + i * unit, data + (i + 1) * unit);
+  }
+}
+
+void put_integer(std::ostream& os, boost::uint64_t value, int bytes) {
+  char out[8];
+  for (int i = 0; i < bytes; ++i) {
+    out[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+  os.write(out, bytes);
+}
+
+boost::uint64_t get_integer(const unsigned char* in, int bytes) {
+  boost::uint64_t value(0);
+  for (int i = bytes - 1; i >= 0; --i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+void put_units(std::ostream& os, const void* data, std::size_t count, std::size_t unit) {
+  const char* in(static_cast<const char*>(data));
+  if (unit == 1 || little_endian_host()) {
+    os.write(in, count * unit);
+    return;
+  }
+
+  char chunk[4096];
+  std::size_t per_chunk(sizeof(chunk) / unit);
+  for (std::size_t done = 0; done < count;) {
+    std::size_t n(std::min(per_chunk, count - done));
+    std::memcpy(chunk, in + done * unit, n * unit);
+    swap_units(chunk, n, unit);
+    os.write(chunk, n * unit);
+    done += n;
+  }
+}
+
+void put_padding(std::ostream& os, std::size_t bytes) {
+  static const char zeros[8] = { 0 };
+  os.write(zeros, padding(bytes));
+}
+
+std::size_t element_bytes(j_value_type type) {
+  switch (type) {
+  case j_value_type_int8:
+    return sizeof(JInt8);
+  case j_value_type_int16:
+    return sizeof(JInt16);
+  case j_value_type_int:
+    return sizeof(JInt);
+  case j_value_type_int64:
+    return sizeof(JInt64);
+  case j_value_type_float:
+    return sizeof(JFloat);
+  case j_value_type_complex:
+    return sizeof(JComplex);
+  case j_value_type_char:
+    return sizeof(JChar);
+  default:
+    throw JIllegalValueTypeException();
+  }
+}
+
+std::size_t bool_words(std::size_t n) {
+  return (n + bits_per_word - 1) / bits_per_word;
+}
+
+std::size_t payload_bytes(j_value_type type, JSize elems) {
+  if (type == j_value_type_bool) return bool_words(elems) * sizeof(JBitWord);
+  return elems * element_bytes(type);
+}
+
+std::size_t record_size(const JNoun& noun) {
+  std::size_t bytes(8 + 8 * noun.get_rank());
+  std::size_t n(noun.get_dims().number_of_elems());
+
+  switch (noun.get_value_type()) {
+  case j_value_type_bool:
+    return bytes + bool_words(n) * sizeof(JBitWord);
+  case j_value_type_box: {
+    const JArray<JBox>& boxes(static_cast<const JArray<JBox>&>(noun));
+    for (JArray<JBox>::iter i = boxes.begin(); i != boxes.end(); ++i) {
+      bytes += record_size(*i->get_contents());
+    }
+    return bytes;
+  }
+  default: {
+    std::size_t payload(n * element_bytes(noun.get_value_type()));
+    return bytes + payload + padding(payload);
+  }
+  }
+}
+
+void encode_record(std::ostream& os, const JNoun& noun);
+
+template <typename T>
+std::size_t write_payload(std::ostream& os, const JArray<T>& arr) {
+  std::size_t bytes(arr.get_dims().number_of_elems() * sizeof(T));
+  if (bytes > 0) {
+    put_units(os, arr.begin(), bytes / WireTraits<T>::unit(), WireTraits<T>::unit());
+  }
+  return bytes;
+}
+
+std::size_t write_payload(std::ostream& os, const JArray<JBool>& arr) {
+  std::size_t n(arr.get_dims().number_of_elems());
+  if (n == 0) return 0;
+
+  JBitIterator begin(arr.begin());
+  if (word_aligned(begin)) {
+    put_units(os, first_word(begin), n / bits_per_word, sizeof(JBitWord));
+    if (n % bits_per_word) {
+      JBitWord tail(first_word(begin)[n / bits_per_word] & ((JBitWord(1) << n % bits_per_word) - 1));
+      put_units(os, &tail, 1, sizeof(JBitWord));
+    }
+  } else {
+    vector<JBitWord> packed(bool_words(n), 0);
+    std::copy(begin, begin + n, JBitIterator(&packed[0], 0));
+    put_units(os, &packed[0], packed.size(), sizeof(JBitWord));
+  }
+  return bool_words(n) * sizeof(JBitWord);
+}
+
+std::size_t write_payload(std::ostream& os, const JArray<JBox>& arr) {
+  for (JArray<JBox>::iter i = arr.begin(); i != arr.end(); ++i) {
+    encode_record(os, *i->get_contents());
+  }
+  return 0;
+}
+
+void encode_header(std::ostream& os, j_value_type type, const Dimensions& d) {
+  put_integer(os, type, 1);
+  put_integer(os, 0, 3);
+  put_integer(os, d.get_rank(), 4);
+  for (Dimensions::iter i = d.begin(); i != d.end(); ++i) {
+    put_integer(os, *i, 8);
+  }
+}
+
+void encode_payload(std::ostream& os, const JNoun& noun) {
+  std::size_t bytes;
+  switch (noun.get_value_type()) {
+  case j_value_type_bool:
+    bytes = write_payload(os, static_cast<const JArray<JBool>&>(noun));
+    break;
+  case j_value_type_int8:
+    bytes = write_payload(os, static_cast<const JArray<JInt8>&>(noun));
+    break;
+  case j_value_type_int16:
+    bytes = write_payload(os, static_cast<const JArray<JInt16>&>(noun));
+    break;
+  case j_value_type_int:
+    bytes = write_payload(os, static_cast<const JArray<JInt>&>(noun));
+    break;
+  case j_value_type_int64:
+    bytes = write_payload(os, static_cast<const JArray<JInt64>&>(noun));
+    break;
+  case j_value_type_float:
+    bytes = write_payload(os, static_cast<const JArray<JFloat>&>(noun));
+    break;
+  case j_value_type_complex:
+    bytes = write_payload(os, static_cast<const JArray<JComplex>&>(noun));
+    break;
+  case j_value_type_char:
+    bytes = write_payload(os, static_cast<const JArray<JChar>&>(noun));
+    break;
+  case j_value_type_box:
+    bytes = write_payload(os, static_cast<const JArray<JBox>&>(noun));
+    break;
+  default:
+    throw JIllegalValueTypeException();
+  }
+  put_padding(os, bytes);
+}
+
+void encode_record(std::ostream& os, const JNoun& noun) {
+  encode_header(os, noun.get_value_type(), noun.get_dims());
+  encode_payload(os, noun);
+}
+
+class NounSource {
+public:
+  virtual ~NounSource() {}
+
+  virtual void read(void* out, std::size_t bytes) = 0;
+  virtual void skip(std::size_t bytes) = 0;
+  // Throws unless the next bytes are present, so that header extents are not
+  // trusted with an allocation before the payload has been seen.
+  virtual void require(std::size_t bytes) = 0;
+  // The current position if payloads can be referenced in place, otherwise 0.
+  virtual const char* position() const = 0;
+  virtual shared_ptr<void> get_owner() const = 0;
+  virtual bool is_writable() const = 0;
+};
+
+class StreamSource: public NounSource {
+  std::istream& is;
+  // Bytes read ahead by require, consumed from pending_start.
+  vector<char> pending;
+  std::size_t pending_start;
+
+  void fill(char* out, std::size_t bytes) {
+    is.read(out, bytes);
+    if (static_cast<std::size_t>(is.gcount()) != bytes) {
+      throw JSerializationException("Serialized noun is truncated");
+    }
+  }
+
+public:
+  StreamSource(std::istream& is): is(is), pending_start(0) {}
+
+  void read(void* out, std::size_t bytes) {
+    std::size_t buffered(std::min(bytes, pending.size() - pending_start));
+    if (buffered > 0) {
+      std::memcpy(out, &pending[pending_start], buffered);
+      pending_start += buffered;
+      if (pending_start == pending.size()) {
+	pending.clear();
+	pending_start = 0;
+      }
+    }
+    if (bytes > buffered) fill(static_cast<char*>(out) + buffered, bytes - buffered);
+  }
+
+  // Small payloads are allocated for straight away; larger ones are read
+  // ahead a chunk at a time, so memory only grows with bytes actually sent.
+  void require(std::size_t bytes) {
+    if (bytes <= serialization_chunk_bytes) return;
+    while (pending.size() - pending_start < bytes) {
+      std::size_t chunk(std::min(bytes - (pending.size() - pending_start), serialization_chunk_bytes));
+      std::size_t old_size(pending.size());
+      pending.resize(old_size + chunk);
+      fill(&pending[old_size], chunk);
+    }
+  }
+
+  void skip(std::size_t bytes) {
+    char ignored[8];
+    assert(bytes <= sizeof(ignored));
+    read(ignored, bytes);
+  }
+
+  const char* position() const { return 0; }
+  shared_ptr<void> get_owner() const { return shared_ptr<void>(); }
+  bool is_writable() const { return false; }
+};
+
+class MemorySource: public NounSource {
+  const char* cursor;
+  const char* limit;
+  shared_ptr<void> owner;
+  bool writable;
+
+public:
+  MemorySource(const char* data, std::size_t bytes, shared_ptr<void> owner, bool writable):
+    cursor(data), limit(data + bytes), owner(owner), writable(writable) {}
+
+  void read(void* out, std::size_t bytes) {
+    const char* from(cursor);
+    skip(bytes);
+    std::memcpy(out, from, bytes);
+  }
+
+  void skip(std::size_t bytes) {
+    require(bytes);
+    cursor += bytes;
+  }
+
+  void require(std::size_t bytes) {
+    if (static_cast<std::size_t>(limit - cursor) < bytes) {
+      throw JSerializationException("Serialized noun is truncated");
+    }
+  }
+
+  const char* position() const { return owner ? cursor : 0; }
+  shared_ptr<void> get_owner() const { return owner; }
+  bool is_writable() const { return writable; }
+};
+
+JNoun::Ptr decode_record(NounSource& source);
+
+template <typename T>
+JNoun::Ptr decode_payload(NounSource& source, const Dimensions& d) {
+  std::size_t bytes(d.number_of_elems() * sizeof(T));
+  std::size_t unit(WireTraits<T>::unit());
+
+  source.require(bytes + padding(bytes));
+  const char* data(source.position());
+  if (data && d.get_rank() > 0 && little_endian_host() &&
+      reinterpret_cast<std::size_t>(data) % unit == 0) {
+    source.skip(bytes + padding(bytes));
+    return external_array<T>(d, reinterpret_cast<const T*>(data), source.get_owner(), 
+			     source.is_writable());
+  }
+
+  intrusive_ptr<JArray<T> > arr(allocated_array<T>(d));
+  if (bytes > 0) {
+    char* out(reinterpret_cast<char*>(arr->begin()));
+    source.read(out, bytes);
+    if (!little_endian_host()) swap_units(out, bytes / unit, unit);
+  }
+  source.skip(padding(bytes));
+  return arr;
+}
+
+template <>
+JNoun::Ptr decode_payload<JBool>(NounSource& source, const Dimensions& d) {
+  std::size_t words(bool_words(d.number_of_elems()));
+  source.require(words * sizeof(JBitWord));
+  intrusive_ptr<JArray<JBool> > arr(allocated_array<JBool>(d));
+  if (words > 0) {
+    JBitWord* out(first_word(arr->begin()));
+    source.read(out, words * sizeof(JBitWord));
+    if (!little_endian_host()) swap_units(reinterpret_cast<char*>(out), words, sizeof(JBitWord));
+  }
+  return arr;
+}
+
+template <>
+JNoun::Ptr decode_payload<JBox>(NounSource& source, const Dimensions& d) {
+  // Every element is at least a record head.
+  source.require(d.number_of_elems() * 8);
+  intrusive_ptr<JArray<JBox> > arr(allocated_array<JBox>(d));
+  for (JArray<JBox>::iter i = arr->begin(); i != arr->end(); ++i) {
+    *i = JBox(decode_record(source));
+  }
+  return arr;
+}
+
+JNoun::Ptr decode_record(NounSource& source) {
+  unsigned char head[8];
+  source.read(head, sizeof(head));
+
+  boost::uint32_t rank(get_integer(head + 4, 4));
+  if (head[0] > j_value_type_box || rank > serialization_max_rank) {
+    throw JSerializationException();
+  }
+
+  vector<JSize> dims(rank);
+  JSize elems(1);
+  for (boost::uint32_t i = 0; i < rank; ++i) {
+    unsigned char extent[8];
+    source.read(extent, sizeof(extent));
+    dims[i] = get_integer(extent, 8);
+    if (dims[i] < 0 || (dims[i] > 0 && elems > std::numeric_limits<JSize>::max() / 16 / dims[i])) {
+      throw JSerializationException();
+    }
+    elems *= dims[i];
+  }
+  Dimensions d(Dimensions::from_range(dims.begin(), dims.end()));
+
+  switch (head[0]) {
+  case j_value_type_bool:
+    return decode_payload<JBool>(source, d);
+  case j_value_type_int8:
+    return decode_payload<JInt8>(source, d);
+  case j_value_type_int16:
+    return decode_payload<JInt16>(source, d);
+  case j_value_type_int:
+    return decode_payload<JInt>(source, d);
+  case j_value_type_int64:
+    return decode_payload<JInt64>(source, d);
+  case j_value_type_float:
+    return decode_payload<JFloat>(source, d);
+  case j_value_type_complex:
+    return decode_payload<JComplex>(source, d);
+  case j_value_type_char:
+    return decode_payload<JChar>(source, d);
+  default:
+    return decode_payload<JBox>(source, d);
+  }
+}
+
+JNoun::Ptr decode_message(NounSource& source) {
+  unsigned char header[serialization_header_bytes];
+  source.read(header, sizeof(header));
+  if (header[0] != 'J' || header[1] != 'N' || header[2] != 'B') {
+    throw JSerializationException("Not a serialized noun");
+  }
+  if (header[3] == 0 || header[3] > serialization_version) {
+    throw JSerializationException("Unsupported serialization version");
+  }
+  return decode_record(source);
+}
+
+std::size_t encoded_size(const JNoun& noun) {
+  return serialization_header_bytes + record_size(noun);
+}
+
+void encode_noun(std::ostream& os, const JNoun& noun) {
+  os.write("JNB", 3);
+  put_integer(os, serialization_version, 1);
+  put_integer(os, 0, 4);
+  encode_record(os, noun);
+  if (!os) throw JSerializationException("Failed to write serialized noun");
+}
+
+JNoun::Ptr decode_noun(std::istream& is) {
+  StreamSource source(is);
+  return decode_message(source);
+}
+
+JNoun::Ptr decode_noun(const char* data, std::size_t bytes, shared_ptr<void> owner, bool writable) {
+  MemorySource source(data, bytes, owner, writable);
+  return decode_message(source);
+}
+
+}
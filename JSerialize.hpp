@@ -0,0 +1,36 @@
+#ifndef JSERIALIZE_HPP
+#define JSERIALIZE_HPP
+
+#include "JNoun.hpp"
+#include <iostream>
+
+namespace J {
+
+// A serialized noun is an 8 byte header ("JNB", a version byte and four reserved bytes)
+// followed by one record. A record is the value type byte, three reserved bytes, the
+// rank as a 32 bit integer and one 64 bit integer per axis, followed by the payload
+// padded to a multiple of 8 bytes. Integers and payloads are little-endian, booleans
+// are packed 64 to a word starting from the least significant bit and a box payload is
+// one record per element. Value types are written as their j_value_type, so new types
+// have to be appended to the enumeration.
+const unsigned char serialization_version = 1;
+
+std::size_t encoded_size(const JNoun& noun);
+void encode_noun(std::ostream& os, const JNoun& noun);
+JNoun::Ptr decode_noun(std::istream& is);
+
+// Payloads that are suitably aligned in memory are wrapped instead of copied, and keep
+// owner alive for as long as they are referenced. Without an owner everything is copied;
+// wrapped payloads are only updated in place by verbs if they are declared writable.
+JNoun::Ptr decode_noun(const char* data, std::size_t bytes, shared_ptr<void> owner, 
+		       bool writable = false);
+
+// The two halves of a record, for writers that patch records in place. payload_bytes
+// excludes padding and is undefined for boxes, whose payload is a list of records.
+void encode_header(std::ostream& os, j_value_type type, const Dimensions& d);
+void encode_payload(std::ostream& os, const JNoun& noun);
+std::size_t payload_bytes(j_value_type type, JSize elems);
+
+}
+
+#endif
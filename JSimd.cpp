@@ -0,0 +1,547 @@
+#include "JSimd.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define J_SIMD_X86
+// GCC 12 reports the deliberately undefined vectors in the AVX-512 headers once inlined.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+namespace J {
+
+simd_level detected_simd_level() {
+#ifdef J_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return simd_level_avx512;
+  if (__builtin_cpu_supports("avx2")) return simd_level_avx2;
+  if (__builtin_cpu_supports("sse2")) return simd_level_sse2;
+#endif
+  return simd_level_scalar;
+}
+
+static simd_level& current_simd_level() {
+  static simd_level level(detected_simd_level());
+  return level;
+}
+
+simd_level get_simd_level() {
+  return current_simd_level();
+}
+
+simd_level set_simd_level(simd_level level) {
+  return current_simd_level() = std::min(level, detected_simd_level());
+}
+
+#ifdef J_SIMD_X86
+
+// Each instruction set is a struct of static functions with the same names, so that one
+// set of loops serves all of them. Only the structs and the entry points at the end are
+// compiled for their instruction set, and the entry points flatten the loops into
+// themselves; vectors are passed by reference so that no call needs the wider ABI.
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+struct Sse2 {
+  typedef __m128d vfloat;
+  typedef __m128i vint;
+
+  static void load(const JFloat* p, vfloat& v) { v = _mm_loadu_pd(p); }
+  static void load(const JInt* p, vint& v) { v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+  static void store(JFloat* p, const vfloat& v) { _mm_storeu_pd(p, v); }
+  static void store(JInt* p, const vint& v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+  static void load_float(const JInt* p, vfloat& v) {
+    v = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+  }
+
+  static void add(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_add_pd(a, b); }
+  static void subtract(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_sub_pd(a, b); }
+  static void multiply(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_mul_pd(a, b); }
+  static void divide(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_div_pd(a, b); }
+  // minpd and maxpd return their second operand when either is NaN, as std::min and
+  // std::max return their first.
+  static void lesser(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_min_pd(b, a); }
+  static void greater(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm_max_pd(b, a); }
+
+  static void lesser(const vint& a, const vint& b, vint& r) {
+    vint more(_mm_cmpgt_epi32(a, b));
+    r = _mm_or_si128(_mm_and_si128(more, b), _mm_andnot_si128(more, a));
+  }
+
+  static void greater(const vint& a, const vint& b, vint& r) {
+    vint more(_mm_cmpgt_epi32(a, b));
+    r = _mm_or_si128(_mm_and_si128(more, a), _mm_andnot_si128(more, b));
+  }
+
+  static JBitWord lessequal(const vfloat& a, const vfloat& b) { return _mm_movemask_pd(_mm_cmple_pd(a, b)); }
+  static JBitWord moreequal(const vfloat& a, const vfloat& b) { return _mm_movemask_pd(_mm_cmpge_pd(a, b)); }
+
+  static JBitWord lessequal(const vint& a, const vint& b) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b))) ^ 0xf;
+  }
+
+  static JBitWord moreequal(const vint& a, const vint& b) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(b, a))) ^ 0xf;
+  }
+
+  // Overflow is accumulated in the sign bits of a vector.
+  static void clear(vint& v) { v = _mm_setzero_si128(); }
+  static bool any_negative(const vint& v) { return _mm_movemask_ps(_mm_castsi128_ps(v)) != 0; }
+
+  static void checked_add(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm_add_epi32(a, b);
+    overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(a, r), _mm_xor_si128(b, r)));
+  }
+
+  static void checked_subtract(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm_sub_epi32(a, b);
+    overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r)));
+  }
+
+  // Products of 32 bit integers are exact in doubles whenever they fit in 32 bits, and
+  // round to outside the range whenever they do not.
+  static void checked_multiply(const vint& a, const vint& b, vint& r, vint& overflow) {
+    vfloat low(_mm_mul_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)));
+    vfloat high(_mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)), _mm_cvtepi32_pd(_mm_unpackhi_epi64(b, b))));
+    vfloat max(_mm_set1_pd(2147483647.0)), min(_mm_set1_pd(-2147483648.0));
+    vfloat outside(_mm_or_pd(_mm_or_pd(_mm_cmpgt_pd(low, max), _mm_cmplt_pd(low, min)),
+			     _mm_or_pd(_mm_cmpgt_pd(high, max), _mm_cmplt_pd(high, min))));
+    overflow = _mm_or_si128(overflow, _mm_castpd_si128(outside));
+    r = _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high));
+  }
+};
+
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+struct Avx2 {
+  typedef __m256d vfloat;
+  typedef __m256i vint;
+
+  static void load(const JFloat* p, vfloat& v) { v = _mm256_loadu_pd(p); }
+  static void load(const JInt* p, vint& v) { v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  static void store(JFloat* p, const vfloat& v) { _mm256_storeu_pd(p, v); }
+  static void store(JInt* p, const vint& v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+  static void load_float(const JInt* p, vfloat& v) {
+    v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+
+  static void add(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_add_pd(a, b); }
+  static void subtract(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_sub_pd(a, b); }
+  static void multiply(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_mul_pd(a, b); }
+  static void divide(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_div_pd(a, b); }
+  static void lesser(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_min_pd(b, a); }
+  static void greater(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm256_max_pd(b, a); }
+  static void lesser(const vint& a, const vint& b, vint& r) { r = _mm256_min_epi32(a, b); }
+  static void greater(const vint& a, const vint& b, vint& r) { r = _mm256_max_epi32(a, b); }
+
+  static JBitWord lessequal(const vfloat& a, const vfloat& b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+  }
+
+  static JBitWord moreequal(const vfloat& a, const vfloat& b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ));
+  }
+
+  static JBitWord lessequal(const vint& a, const vint& b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))) ^ 0xff;
+  }
+
+  static JBitWord moreequal(const vint& a, const vint& b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))) ^ 0xff;
+  }
+
+  static void clear(vint& v) { v = _mm256_setzero_si256(); }
+  static bool any_negative(const vint& v) { return _mm256_movemask_ps(_mm256_castsi256_ps(v)) != 0; }
+
+  static void checked_add(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm256_add_epi32(a, b);
+    overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r)));
+  }
+
+  static void checked_subtract(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm256_sub_epi32(a, b);
+    overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r)));
+  }
+
+  static void checked_multiply(const vint& a, const vint& b, vint& r, vint& overflow) {
+    vfloat low(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+			     _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))));
+    vfloat high(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+			      _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))));
+    vfloat max(_mm256_set1_pd(2147483647.0)), min(_mm256_set1_pd(-2147483648.0));
+    vfloat outside(_mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(low, max, _CMP_GT_OQ),
+					     _mm256_cmp_pd(low, min, _CMP_LT_OQ)),
+				_mm256_or_pd(_mm256_cmp_pd(high, max, _CMP_GT_OQ),
+					     _mm256_cmp_pd(high, min, _CMP_LT_OQ))));
+    overflow = _mm256_or_si256(overflow, _mm256_castpd_si256(outside));
+    r = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(low)), _mm256_cvttpd_epi32(high), 1);
+  }
+};
+
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+struct Avx512 {
+  typedef __m512d vfloat;
+  typedef __m512i vint;
+
+  static void load(const JFloat* p, vfloat& v) { v = _mm512_loadu_pd(p); }
+  static void load(const JInt* p, vint& v) { v = _mm512_loadu_si512(p); }
+  static void store(JFloat* p, const vfloat& v) { _mm512_storeu_pd(p, v); }
+  static void store(JInt* p, const vint& v) { _mm512_storeu_si512(p, v); }
+
+  static void load_float(const JInt* p, vfloat& v) {
+    v = _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  }
+
+  static void add(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_add_pd(a, b); }
+  static void subtract(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_sub_pd(a, b); }
+  static void multiply(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_mul_pd(a, b); }
+  static void divide(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_div_pd(a, b); }
+  static void lesser(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_min_pd(b, a); }
+  static void greater(const vfloat& a, const vfloat& b, vfloat& r) { r = _mm512_max_pd(b, a); }
+  static void lesser(const vint& a, const vint& b, vint& r) { r = _mm512_min_epi32(a, b); }
+  static void greater(const vint& a, const vint& b, vint& r) { r = _mm512_max_epi32(a, b); }
+
+  static JBitWord lessequal(const vfloat& a, const vfloat& b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+  static JBitWord moreequal(const vfloat& a, const vfloat& b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+  static JBitWord lessequal(const vint& a, const vint& b) { return _mm512_cmple_epi32_mask(a, b); }
+  static JBitWord moreequal(const vint& a, const vint& b) { return _mm512_cmpge_epi32_mask(a, b); }
+
+  static void clear(vint& v) { v = _mm512_setzero_si512(); }
+  static bool any_negative(const vint& v) { return _mm512_cmplt_epi32_mask(v, _mm512_setzero_si512()) != 0; }
+
+  static void checked_add(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm512_add_epi32(a, b);
+    overflow = _mm512_or_si512(overflow, _mm512_and_si512(_mm512_xor_si512(a, r), _mm512_xor_si512(b, r)));
+  }
+
+  static void checked_subtract(const vint& a, const vint& b, vint& r, vint& overflow) {
+    r = _mm512_sub_epi32(a, b);
+    overflow = _mm512_or_si512(overflow, _mm512_and_si512(_mm512_xor_si512(a, b), _mm512_xor_si512(a, r)));
+  }
+
+  static void checked_multiply(const vint& a, const vint& b, vint& r, vint& overflow) {
+    vfloat low(_mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(a)),
+			     _mm512_cvtepi32_pd(_mm512_castsi512_si256(b))));
+    vfloat high(_mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(a, 1)),
+			      _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(b, 1))));
+    vfloat max(_mm512_set1_pd(2147483647.0)), min(_mm512_set1_pd(-2147483648.0));
+    __mmask16 outside((_mm512_cmp_pd_mask(low, max, _CMP_GT_OQ) | _mm512_cmp_pd_mask(low, min, _CMP_LT_OQ)) |
+		      (_mm512_cmp_pd_mask(high, max, _CMP_GT_OQ) | _mm512_cmp_pd_mask(high, min, _CMP_LT_OQ)) << 8);
+    overflow = _mm512_mask_mov_epi32(overflow, outside, _mm512_set1_epi32(-1));
+    r = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epi32(low)), _mm512_cvttpd_epi32(high), 1);
+  }
+};
+
+#pragma GCC pop_options
+
+template <typename Isa, typename T>
+struct Lanes;
+
+template <typename Isa>
+struct Lanes<Isa, JFloat> {
+  typedef typename Isa::vfloat vector;
+  static const std::size_t width = sizeof(vector) / sizeof(JFloat);
+};
+
+template <typename Isa>
+struct Lanes<Isa, JInt> {
+  typedef typename Isa::vint vector;
+  static const std::size_t width = sizeof(vector) / sizeof(JInt);
+};
+
+// The scalar halves of the operations finish the elements that do not fill a vector, and
+// match the verbs' own operations exactly.
+struct VectorAdd {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::add(a, b, r); }
+  static JFloat apply(JFloat a, JFloat b) { return a + b; }
+};
+
+struct VectorSubtract {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::subtract(a, b, r); }
+  static JFloat apply(JFloat a, JFloat b) { return a - b; }
+};
+
+struct VectorMultiply {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::multiply(a, b, r); }
+  static JFloat apply(JFloat a, JFloat b) { return a * b; }
+};
+
+struct VectorDivide {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::divide(a, b, r); }
+  static JFloat apply(JFloat a, JFloat b) { return a / b; }
+};
+
+struct VectorLesser {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::lesser(a, b, r); }
+  template <typename T>
+  static T apply(T a, T b) { return std::min(a, b); }
+};
+
+struct VectorGreater {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r) { Isa::greater(a, b, r); }
+  template <typename T>
+  static T apply(T a, T b) { return std::max(a, b); }
+};
+
+struct VectorLessequal {
+  template <typename Isa, typename V>
+  static JBitWord mask(const V& a, const V& b) { return Isa::lessequal(a, b); }
+  template <typename T>
+  static bool apply(T a, T b) { return a <= b; }
+};
+
+struct VectorMoreequal {
+  template <typename Isa, typename V>
+  static JBitWord mask(const V& a, const V& b) { return Isa::moreequal(a, b); }
+  template <typename T>
+  static bool apply(T a, T b) { return a >= b; }
+};
+
+struct VectorCheckedAdd {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r, V& overflow) { Isa::checked_add(a, b, r, overflow); }
+  static JInt64 apply(JInt64 a, JInt64 b) { return a + b; }
+};
+
+struct VectorCheckedSubtract {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r, V& overflow) { Isa::checked_subtract(a, b, r, overflow); }
+  static JInt64 apply(JInt64 a, JInt64 b) { return a - b; }
+};
+
+struct VectorCheckedMultiply {
+  template <typename Isa, typename V>
+  static void apply(const V& a, const V& b, V& r, V& overflow) { Isa::checked_multiply(a, b, r, overflow); }
+  static JInt64 apply(JInt64 a, JInt64 b) { return a * b; }
+};
+
+template <typename Isa, typename Op, typename T>
+void transform_lanes(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  typedef typename Lanes<Isa, T>::vector V;
+  const std::size_t width(Lanes<Isa, T>::width);
+  std::size_t i(0);
+  for (V a, b, r; i + width <= n; i += width) {
+    Isa::load(lhs + i, a);
+    Isa::load(rhs + i, b);
+    Op::template apply<Isa>(a, b, r);
+    Isa::store(out + i, r);
+  }
+  for (; i < n; ++i) out[i] = Op::apply(lhs[i], rhs[i]);
+}
+
+template <typename Isa>
+void divide_lanes(const JInt* lhs, const JInt* rhs, JFloat* out, std::size_t n) {
+  typedef typename Lanes<Isa, JFloat>::vector V;
+  const std::size_t width(Lanes<Isa, JFloat>::width);
+  std::size_t i(0);
+  for (V a, b, r; i + width <= n; i += width) {
+    Isa::load_float(lhs + i, a);
+    Isa::load_float(rhs + i, b);
+    Isa::divide(a, b, r);
+    Isa::store(out + i, r);
+  }
+  for (; i < n; ++i) out[i] = static_cast<JFloat>(lhs[i]) / static_cast<JFloat>(rhs[i]);
+}
+
+// Every vector width divides the word size, so whole words are assembled from masks and
+// only the bits of a final partial word are merged into it.
+template <typename Isa, typename Op, typename T>
+void compare_lanes(const T* lhs, const T* rhs, JBitWord* words, std::size_t n) {
+  typedef typename Lanes<Isa, T>::vector V;
+  const std::size_t width(Lanes<Isa, T>::width);
+  std::size_t i(0);
+  for (V a, b; i + bits_per_word <= n; ++words) {
+    JBitWord word(0);
+    for (std::size_t bit = 0; bit < bits_per_word; bit += width, i += width) {
+      Isa::load(lhs + i, a);
+      Isa::load(rhs + i, b);
+      word |= Op::template mask<Isa>(a, b) << bit;
+    }
+    *words = word;
+  }
+  if (i < n) {
+    JBitWord word(0);
+    std::size_t bit(0);
+    for (; i < n; ++i, ++bit) word |= JBitWord(Op::apply(lhs[i], rhs[i])) << bit;
+    JBitWord written((JBitWord(1) << bit) - 1);
+    *words = (*words & ~written) | word;
+  }
+}
+
+template <typename Isa, typename Op>
+bool checked_lanes(const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n) {
+  typedef typename Lanes<Isa, JInt>::vector V;
+  const std::size_t width(Lanes<Isa, JInt>::width);
+  std::size_t i(0);
+  V a, b, r, overflow;
+  Isa::clear(overflow);
+  for (; i + width <= n; i += width) {
+    Isa::load(lhs + i, a);
+    Isa::load(rhs + i, b);
+    Op::template apply<Isa>(a, b, r, overflow);
+    Isa::store(out + i, r);
+  }
+  bool overflowed(Isa::any_negative(overflow));
+  for (; i < n; ++i) {
+    JInt64 exact(Op::apply(lhs[i], rhs[i]));
+    out[i] = static_cast<JInt>(exact);
+    overflowed |= out[i] != exact;
+  }
+  return overflowed;
+}
+
+template <typename Isa>
+bool transform_kernel(simd_op op, const JFloat* lhs, const JFloat* rhs, JFloat* out, std::size_t n) {
+  switch (op) {
+  case simd_op_add: transform_lanes<Isa, VectorAdd>(lhs, rhs, out, n); return true;
+  case simd_op_subtract: transform_lanes<Isa, VectorSubtract>(lhs, rhs, out, n); return true;
+  case simd_op_multiply: transform_lanes<Isa, VectorMultiply>(lhs, rhs, out, n); return true;
+  case simd_op_divide: transform_lanes<Isa, VectorDivide>(lhs, rhs, out, n); return true;
+  case simd_op_lesser: transform_lanes<Isa, VectorLesser>(lhs, rhs, out, n); return true;
+  case simd_op_greater: transform_lanes<Isa, VectorGreater>(lhs, rhs, out, n); return true;
+  default: return false;
+  }
+}
+
+template <typename Isa>
+bool transform_kernel(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n) {
+  switch (op) {
+  case simd_op_lesser: transform_lanes<Isa, VectorLesser>(lhs, rhs, out, n); return true;
+  case simd_op_greater: transform_lanes<Isa, VectorGreater>(lhs, rhs, out, n); return true;
+  default: return false;
+  }
+}
+
+template <typename Isa>
+bool transform_kernel(simd_op op, const JInt* lhs, const JInt* rhs, JFloat* out, std::size_t n) {
+  if (op != simd_op_divide) return false;
+  divide_lanes<Isa>(lhs, rhs, out, n);
+  return true;
+}
+
+template <typename Isa, typename T>
+bool compare_kernel(simd_op op, const T* lhs, const T* rhs, JBitWord* out, std::size_t n) {
+  switch (op) {
+  case simd_op_lessequal: compare_lanes<Isa, VectorLessequal>(lhs, rhs, out, n); return true;
+  case simd_op_moreequal: compare_lanes<Isa, VectorMoreequal>(lhs, rhs, out, n); return true;
+  default: return false;
+  }
+}
+
+template <typename Isa>
+bool checked_kernel(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n, bool& overflow) {
+  switch (op) {
+  case simd_op_add: overflow = checked_lanes<Isa, VectorCheckedAdd>(lhs, rhs, out, n); return true;
+  case simd_op_subtract: overflow = checked_lanes<Isa, VectorCheckedSubtract>(lhs, rhs, out, n); return true;
+  case simd_op_multiply: overflow = checked_lanes<Isa, VectorCheckedMultiply>(lhs, rhs, out, n); return true;
+  default: return false;
+  }
+}
+
+// The kernels for one instruction set, with everything they call inlined into code
+// compiled for it.
+#define J_SIMD_ENTRY_POINTS(Isa, prefix, isa)				\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JFloat* out, std::size_t n) { \
+    return transform_kernel<Isa>(op, lhs, rhs, out, n);		\
+  }									\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n) { \
+    return transform_kernel<Isa>(op, lhs, rhs, out, n);		\
+  }									\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_transform(simd_op op, const JInt* lhs, const JInt* rhs, JFloat* out, std::size_t n) { \
+    return transform_kernel<Isa>(op, lhs, rhs, out, n);		\
+  }									\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JBitWord* out, std::size_t n) { \
+    return compare_kernel<Isa>(op, lhs, rhs, out, n);			\
+  }									\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_transform(simd_op op, const JInt* lhs, const JInt* rhs, JBitWord* out, std::size_t n) { \
+    return compare_kernel<Isa>(op, lhs, rhs, out, n);			\
+  }									\
+  __attribute__((target(isa), flatten))					\
+  bool prefix##_checked_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n, \
+				  bool& overflow) {			\
+    return checked_kernel<Isa>(op, lhs, rhs, out, n, overflow);	\
+  }
+
+J_SIMD_ENTRY_POINTS(Sse2, sse2, "sse2")
+J_SIMD_ENTRY_POINTS(Avx2, avx2, "avx2")
+J_SIMD_ENTRY_POINTS(Avx512, avx512, "avx512f")
+
+#undef J_SIMD_ENTRY_POINTS
+
+template <typename T, typename Out>
+bool dispatch_transform(simd_op op, const T* lhs, const T* rhs, Out out, std::size_t n) {
+  switch (get_simd_level()) {
+  case simd_level_avx512: return avx512_transform(op, lhs, rhs, out, n);
+  case simd_level_avx2: return avx2_transform(op, lhs, rhs, out, n);
+  case simd_level_sse2: return sse2_transform(op, lhs, rhs, out, n);
+  default: return false;
+  }
+}
+
+bool simd_checked_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n,
+			    bool& overflow) {
+  switch (get_simd_level()) {
+  case simd_level_avx512: return avx512_checked_transform(op, lhs, rhs, out, n, overflow);
+  case simd_level_avx2: return avx2_checked_transform(op, lhs, rhs, out, n, overflow);
+  case simd_level_sse2: return sse2_checked_transform(op, lhs, rhs, out, n, overflow);
+  default: return false;
+  }
+}
+
+#else
+
+template <typename T, typename Out>
+bool dispatch_transform(simd_op, const T*, const T*, Out, std::size_t) {
+  return false;
+}
+
+bool simd_checked_transform(simd_op, const JInt*, const JInt*, JInt*, std::size_t, bool&) {
+  return false;
+}
+
+#endif
+
+bool simd_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JFloat* out, std::size_t n) {
+  return dispatch_transform(op, lhs, rhs, out, n);
+}
+
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n) {
+  return dispatch_transform(op, lhs, rhs, out, n);
+}
+
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JFloat* out, std::size_t n) {
+  return dispatch_transform(op, lhs, rhs, out, n);
+}
+
+bool simd_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JBitIterator out, std::size_t n) {
+  if (!word_aligned(out)) return false;
+  return dispatch_transform(op, lhs, rhs, out.get_words() + out.get_position() / bits_per_word, n);
+}
+
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JBitIterator out, std::size_t n) {
+  if (!word_aligned(out)) return false;
+  return dispatch_transform(op, lhs, rhs, out.get_words() + out.get_position() / bits_per_word, n);
+}
+
+}
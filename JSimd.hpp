@@ -0,0 +1,62 @@
+#ifndef JSIMD_HPP
+#define JSIMD_HPP
+
+#include "JTypes.hpp"
+#include "JBuffer.hpp"
+#include <cstddef>
+
+namespace J {
+
+// Vector kernels for the elementwise dyads on contiguous int and float arrays. The level
+// is detected from the processor once, and can be lowered to compare kernels against
+// each other; at simd_level_scalar no kernel runs and verbs use their own loops.
+enum simd_level {
+  simd_level_scalar,
+  simd_level_sse2,
+  simd_level_avx2,
+  simd_level_avx512
+};
+
+enum simd_op {
+  simd_op_none,
+  simd_op_add,
+  simd_op_subtract,
+  simd_op_multiply,
+  simd_op_divide,
+  simd_op_lesser,
+  simd_op_greater,
+  simd_op_lessequal,
+  simd_op_moreequal
+};
+
+simd_level detected_simd_level();
+simd_level get_simd_level();
+// Levels the processor lacks are clamped to the best it has; returns the level in use.
+simd_level set_simd_level(simd_level level);
+
+// Each returns false, without touching out, when there is no kernel for the operation and
+// types at the current level. Integer add, subtract and multiply are only available
+// checked, and a bit result has to start on a word boundary.
+bool simd_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JFloat* out, std::size_t n);
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n);
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JFloat* out, std::size_t n);
+bool simd_transform(simd_op op, const JFloat* lhs, const JFloat* rhs, JBitIterator out, std::size_t n);
+bool simd_transform(simd_op op, const JInt* lhs, const JInt* rhs, JBitIterator out, std::size_t n);
+
+template <typename T, typename Out>
+bool simd_transform(simd_op, const T*, const T*, Out, std::size_t) {
+  return false;
+}
+
+// overflow is set if any element overflowed, in which case out is unspecified.
+bool simd_checked_transform(simd_op op, const JInt* lhs, const JInt* rhs, JInt* out, std::size_t n,
+			    bool& overflow);
+
+template <typename T>
+bool simd_checked_transform(simd_op, const T*, const T*, T*, std::size_t, bool&) {
+  return false;
+}
+
+}
+
+#endif
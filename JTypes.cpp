@@ -5,8 +5,26 @@ namespace J {
 TypeConversions::TypeConversions(): type_conversions() {
     typedef pair<j_value_type, j_value_type> p;
     
+    type_conversions.insert(p(j_value_type_bool, j_value_type_int8));
+    type_conversions.insert(p(j_value_type_bool, j_value_type_int16));
+    type_conversions.insert(p(j_value_type_bool, j_value_type_int));
+    type_conversions.insert(p(j_value_type_bool, j_value_type_int64));
+    type_conversions.insert(p(j_value_type_bool, j_value_type_float));
+    type_conversions.insert(p(j_value_type_bool, j_value_type_complex));
+    type_conversions.insert(p(j_value_type_int8, j_value_type_int16));
+    type_conversions.insert(p(j_value_type_int8, j_value_type_int));
+    type_conversions.insert(p(j_value_type_int8, j_value_type_int64));
+    type_conversions.insert(p(j_value_type_int8, j_value_type_float));
+    type_conversions.insert(p(j_value_type_int8, j_value_type_complex));
+    type_conversions.insert(p(j_value_type_int16, j_value_type_int));
+    type_conversions.insert(p(j_value_type_int16, j_value_type_int64));
+    type_conversions.insert(p(j_value_type_int16, j_value_type_float));
+    type_conversions.insert(p(j_value_type_int16, j_value_type_complex));
+    type_conversions.insert(p(j_value_type_int, j_value_type_int64));
     type_conversions.insert(p(j_value_type_int, j_value_type_float));
     type_conversions.insert(p(j_value_type_int, j_value_type_complex));
+    type_conversions.insert(p(j_value_type_int64, j_value_type_float));
+    type_conversions.insert(p(j_value_type_int64, j_value_type_complex));
     type_conversions.insert(p(j_value_type_float, j_value_type_complex));
 }
  
@@ -30,6 +48,30 @@ optional<j_value_type> TypeConversions::find_best_type_conversion(j_value_type t
 }
 
 
+bool compares_by_value(j_value_type from, j_value_type to) {
+  bool narrow_from = from == j_value_type_bool || from == j_value_type_int8 || from == j_value_type_int16;
+  bool integer_to = to == j_value_type_int || to == j_value_type_int64;
+  return (narrow_from || integer_to) && TypeConversions::get_instance()->is_convertible_to(from, to);
+}
+
+j_value_type narrowest_int_type(JInt64 min, JInt64 max) {
+  if (min >= std::numeric_limits<JInt8>::min() && max <= std::numeric_limits<JInt8>::max()) {
+    return j_value_type_int8;
+  }
+  if (min >= std::numeric_limits<JInt16>::min() && max <= std::numeric_limits<JInt16>::max()) {
+    return j_value_type_int16;
+  }
+  if (min >= std::numeric_limits<JInt>::min() && max <= std::numeric_limits<JInt>::max()) {
+    return j_value_type_int;
+  }
+  return j_value_type_int64;
+}
+
+bool is_integer_type(j_value_type type) {
+  return type == j_value_type_bool || type == j_value_type_int8 || type == j_value_type_int16 ||
+    type == j_value_type_int || type == j_value_type_int64;
+}
+
 JNoun::Ptr GetNounAsJArrayOfType::operator()(const JNoun& arg, j_value_type to_type) const {
   if (arg.get_value_type() == to_type) return arg.clone();
   return JArrayCaller<ConversionOp, JNoun::Ptr>()(arg, to_type);
@@ -44,11 +86,19 @@ JArray<T> require_type(const JNoun& noun) {
   if (TypeConversions::get_instance()->is_convertible_to(noun.get_value_type(), JTypeTrait<T>::value_type)) {
     return static_cast<const JArray<T>&>(*GetNounAsJArrayOfType()(noun, JTypeTrait<T>::value_type));
   }
+
+  if (noun.get_dims().number_of_elems() == 0) {
+    return JArray<T>(noun.get_dims(), JBuffer<T>::Instantiate(0));
+  }
   
   throw JIllegalValueTypeException();
 }
 
+template JArray<JBool> require_type<JBool>(const JNoun& noun);
+template JArray<JInt8> require_type<JInt8>(const JNoun& noun);
+template JArray<JInt16> require_type<JInt16>(const JNoun& noun);
 template JArray<JInt> require_type<JInt>(const JNoun& noun);
+template JArray<JInt64> require_type<JInt64>(const JNoun& noun);
 template JArray<JFloat> require_type<JFloat>(const JNoun& noun);
 template JArray<JBox> require_type<JBox>(const JNoun& noun);
 template JArray<JChar> require_type<JChar>(const JNoun& noun);
@@ -9,6 +9,7 @@
 #include <boost/optional.hpp>
 #include <vector>
 #include <utility>
+#include <limits>
 
 namespace J {
 using std::multimap;
@@ -21,8 +22,16 @@ template <template <typename> class Op, typename Ret>
 struct JTypeDispatcher { 
   Ret operator()(j_value_type t) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()();
+    case j_value_type_int8:
+      return Op<JInt8>()();
+    case j_value_type_int16:
+      return Op<JInt16>()();
     case j_value_type_int:
       return Op<JInt>()();
+    case j_value_type_int64:
+      return Op<JInt64>()();
     case j_value_type_float:
       return Op<JFloat>()();
     case j_value_type_box:
@@ -37,8 +46,16 @@ struct JTypeDispatcher {
   template <typename Arg1>
   Ret operator()(j_value_type t, const Arg1& arg) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()(arg);
+    case j_value_type_int8:
+      return Op<JInt8>()(arg);
+    case j_value_type_int16:
+      return Op<JInt16>()(arg);
     case j_value_type_int:
       return Op<JInt>()(arg);
+    case j_value_type_int64:
+      return Op<JInt64>()(arg);
     case j_value_type_float:
       return Op<JFloat>()(arg);
     case j_value_type_box:
@@ -53,8 +70,16 @@ struct JTypeDispatcher {
   template <typename Arg1, typename Arg2>
   Ret operator()(j_value_type t, const Arg1& arg1, const Arg2& arg2) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()(arg1, arg2);
+    case j_value_type_int8:
+      return Op<JInt8>()(arg1, arg2);
+    case j_value_type_int16:
+      return Op<JInt16>()(arg1, arg2);
     case j_value_type_int:
       return Op<JInt>()(arg1, arg2);
+    case j_value_type_int64:
+      return Op<JInt64>()(arg1, arg2);
     case j_value_type_float:
       return Op<JFloat>()(arg1, arg2);
     case j_value_type_box:
@@ -70,8 +95,16 @@ struct JTypeDispatcher {
   template <typename Arg1, typename Arg2, typename Arg3>
   Ret operator()(j_value_type t, const Arg1& arg1, const Arg2& arg2, const Arg3& arg3) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()(arg1, arg2, arg3);
+    case j_value_type_int8:
+      return Op<JInt8>()(arg1, arg2, arg3);
+    case j_value_type_int16:
+      return Op<JInt16>()(arg1, arg2, arg3);
     case j_value_type_int:
       return Op<JInt>()(arg1, arg2, arg3);
+    case j_value_type_int64:
+      return Op<JInt64>()(arg1, arg2, arg3);
     case j_value_type_float:
       return Op<JFloat>()(arg1, arg2, arg3);
     case j_value_type_box:
@@ -86,8 +119,16 @@ struct JTypeDispatcher {
   template <typename Arg1, typename Arg2, typename Arg3, typename Arg4>
   Ret operator()(j_value_type t, const Arg1& arg1, const Arg2& arg2, const Arg3& arg3, const Arg4& arg4) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()(arg1, arg2, arg3, arg4);
+    case j_value_type_int8:
+      return Op<JInt8>()(arg1, arg2, arg3, arg4);
+    case j_value_type_int16:
+      return Op<JInt16>()(arg1, arg2, arg3, arg4);
     case j_value_type_int:
       return Op<JInt>()(arg1, arg2, arg3, arg4);
+    case j_value_type_int64:
+      return Op<JInt64>()(arg1, arg2, arg3, arg4);
     case j_value_type_float:
       return Op<JFloat>()(arg1, arg2, arg3, arg4);
     case j_value_type_box:
@@ -103,8 +144,16 @@ struct JTypeDispatcher {
   Ret operator()(j_value_type t, const Arg1& arg1, const Arg2& arg2, const Arg3& arg3, const Arg4& arg4, 
 		 const Arg5& arg5) const { 
     switch (t) {
+    case j_value_type_bool:
+      return Op<JBool>()(arg1, arg2, arg3, arg4, arg5);
+    case j_value_type_int8:
+      return Op<JInt8>()(arg1, arg2, arg3, arg4, arg5);
+    case j_value_type_int16:
+      return Op<JInt16>()(arg1, arg2, arg3, arg4, arg5);
     case j_value_type_int:
       return Op<JInt>()(arg1, arg2, arg3, arg4, arg5);
+    case j_value_type_int64:
+      return Op<JInt64>()(arg1, arg2, arg3, arg4, arg5);
     case j_value_type_float:
       return Op<JFloat>()(arg1, arg2, arg3, arg4, arg5);
     case j_value_type_box:
@@ -190,6 +239,27 @@ struct ConvertType<JFloat, JComplex> {
   }
 };
     
+template <>
+struct ConvertType<JBool, JInt> {
+  JInt operator()(JBool arg) const {
+    return arg ? 1 : 0;
+  }
+};
+
+template <>
+struct ConvertType<JBool, JFloat> {
+  JFloat operator()(JBool arg) const {
+    return arg ? 1.0 : 0.0;
+  }
+};
+
+template <>
+struct ConvertType<JBool, JComplex> {
+  JComplex operator()(JBool arg) const {
+    return JComplex(arg ? 1.0 : 0.0);
+  }
+};
+
 template <>
 struct ConvertType<JInt, JFloat> {
   JFloat operator()(JInt from) {
@@ -197,6 +267,73 @@ struct ConvertType<JInt, JFloat> {
   }
 };
 
+template <typename From, typename To>
+struct WideningConvertType {
+  To operator()(From arg) const {
+    return static_cast<To>(arg);
+  }
+};
+
+template <>
+struct ConvertType<JBool, JInt8>: WideningConvertType<JBool, JInt8> {};
+
+template <>
+struct ConvertType<JBool, JInt16>: WideningConvertType<JBool, JInt16> {};
+
+template <>
+struct ConvertType<JInt8, JInt16>: WideningConvertType<JInt8, JInt16> {};
+
+template <>
+struct ConvertType<JInt8, JInt>: WideningConvertType<JInt8, JInt> {};
+
+template <>
+struct ConvertType<JInt8, JFloat>: WideningConvertType<JInt8, JFloat> {};
+
+template <>
+struct ConvertType<JInt8, JComplex>: WideningConvertType<JInt8, JComplex> {};
+
+template <>
+struct ConvertType<JInt16, JInt>: WideningConvertType<JInt16, JInt> {};
+
+template <>
+struct ConvertType<JBool, JInt64>: WideningConvertType<JBool, JInt64> {};
+
+template <>
+struct ConvertType<JInt8, JInt64>: WideningConvertType<JInt8, JInt64> {};
+
+template <>
+struct ConvertType<JInt16, JInt64>: WideningConvertType<JInt16, JInt64> {};
+
+template <>
+struct ConvertType<JInt, JInt64>: WideningConvertType<JInt, JInt64> {};
+
+template <>
+struct ConvertType<JInt64, JFloat>: WideningConvertType<JInt64, JFloat> {};
+
+template <>
+struct ConvertType<JInt64, JComplex>: WideningConvertType<JInt64, JComplex> {};
+
+template <>
+struct ConvertType<JInt16, JFloat>: WideningConvertType<JInt16, JFloat> {};
+
+template <>
+struct ConvertType<JInt16, JComplex>: WideningConvertType<JInt16, JComplex> {};
+
+template <typename T>
+struct JKernelType {
+  typedef T type;
+};
+
+template <>
+struct JKernelType<JInt8> {
+  typedef JInt type;
+};
+
+template <>
+struct JKernelType<JInt16> {
+  typedef JInt type;
+};
+
 template <typename From>
 struct CurriedConvertType {
   template <typename To>
@@ -209,17 +346,16 @@ struct CurriedConvertType {
     
 template <typename From, typename To>
 struct ConvertJArray {
-  shared_ptr<JArray<To> > operator()(const JArray<From>& from) const {
-    shared_ptr<vector<To> > to(new vector<To>(from.get_dims().number_of_elems(),
-					     JTypeTrait<To>::base_elem()));
-    transform(from.begin(), from.end(), to->begin(), ConvertType<From, To>());
-    return shared_ptr<JArray<To> >(new JArray<To>(from.get_dims(), to));
+  intrusive_ptr<JArray<To> > operator()(const JArray<From>& from) const {
+    typename JBuffer<To>::Ptr to(JBuffer<To>::Instantiate(from.get_dims().number_of_elems()));
+    std::transform(from.begin(), from.end(), to->begin(), ConvertType<From, To>());
+    return intrusive_ptr<JArray<To> >(new JArray<To>(from.get_dims(), to));
   }
 };
 
 template <typename Arg>
 struct ConvertJArray<Arg, Arg> { 
-  shared_ptr<JArray<Arg> > operator()(const JArray<Arg>& arr) const {
+  intrusive_ptr<JArray<Arg> > operator()(const JArray<Arg>& arr) const {
     return boost::static_pointer_cast<JArray<Arg> >(arr.clone());
   }
 };
@@ -357,6 +493,10 @@ struct CallWithCommonType {
 
 template <typename T>
 JArray<T> require_type(const JNoun& noun);
+
+bool compares_by_value(j_value_type from, j_value_type to);
+j_value_type narrowest_int_type(JInt64 min, JInt64 max);
+bool is_integer_type(j_value_type type);
 }
 
 #endif
@@ -23,6 +23,11 @@ public:
   int get_rrank() const { return rrank; }
 
   virtual JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const = 0;
+  virtual JNoun::Ptr apply_owned(JMachine::Ptr m, const JNoun::Ptr& larg, const JNoun::Ptr& rarg) const {
+    return (*this)(m, *larg, *rarg);
+  }
+  // True when each atom of the result depends only on the atoms at the same position.
+  virtual bool is_elementwise() const { return false; }
 };
 
 class Monad { 
@@ -36,6 +41,10 @@ public:
   int get_rank() const { return rank;}
     
   virtual JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const = 0;
+  virtual JNoun::Ptr apply_owned(JMachine::Ptr m, const JNoun::Ptr& arg) const {
+    return (*this)(m, *arg);
+  }
+  virtual bool is_elementwise() const { return false; }
 };
 
 class JVerb: public JWord {
@@ -43,7 +52,7 @@ class JVerb: public JWord {
   shared_ptr<Dyad> dyad;
 
 public:
-  typedef shared_ptr<JVerb> Ptr;
+  typedef JRef<JVerb> Ptr;
 
   virtual ~JVerb() {}
   JVerb(Monad::Ptr monad, Dyad::Ptr dyad):
@@ -57,14 +66,39 @@ public:
     return (*monad)(m, arg);
   }
 
+  JNoun::Ptr apply_owned(shared_ptr<JMachine> m, const JNoun::Ptr& larg, const JNoun::Ptr& rarg) const {
+    return dyad->apply_owned(m, larg, rarg);
+  }
+
+  JNoun::Ptr apply_owned(shared_ptr<JMachine> m, const JNoun::Ptr& arg) const {
+    return monad->apply_owned(m, arg);
+  }
+
   int get_dyad_lrank() const { return dyad->get_lrank(); }
   int get_dyad_rrank() const { return dyad->get_rrank(); }
   int get_monad_rank() const { return monad->get_rank(); }
+  bool is_monad_elementwise() const { return monad->is_elementwise(); }
+  bool is_dyad_elementwise() const { return dyad->is_elementwise(); }
   
   string to_string() const;
   virtual JNoun::Ptr unit(const Dimensions&) const { 
     throw JNoUnitException();
   }
+
+  virtual JNoun::Ptr reduce(JMachine::Ptr, const JNoun&) const {
+    return JNoun::Ptr();
+  }
+
+  // The reduction of each cell of the given rank, when the verb has a kernel for it.
+  virtual JNoun::Ptr reduce_cells(JMachine::Ptr, const JNoun&, int) const {
+    return JNoun::Ptr();
+  }
+
+  // Lets a verb apply its monad to all cells of a rank at once; a null result leaves it
+  // to monadic_apply.
+  virtual JNoun::Ptr apply_to_cells(JMachine::Ptr, const JNoun&, int) const {
+    return JNoun::Ptr();
+  }
   
 };
 
@@ -22,6 +22,7 @@ bool ParsedNumber<Number>::operator==(const ParsedNumberBase& that) const {
 }
 
 template class ParsedNumber<JInt>;
+template class ParsedNumber<JInt64>;
 template class ParsedNumber<JFloat>;
 template class ParsedNumber<JComplex>;
 }}
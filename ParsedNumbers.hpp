@@ -70,11 +70,13 @@ template <typename T>
 struct create_noun {
   template <typename Iterator>
   JNoun::Ptr operator()(Iterator begin, Iterator end) {
-    int size(distance(begin, end));
-    shared_ptr<vector<T> > vec(new vector<T>(size, JTypeTrait<T>::base_elem()));
+    JSize size(distance(begin, end));
+    if (size == 1) return scalar_noun<T>(ConvertParsedNumberTo<T>()(*begin));
+
+    typename JBuffer<T>::Ptr vec(JBuffer<T>::Instantiate(size));
 
     transform(begin, end, vec->begin(), ConvertParsedNumberTo<T>());
-    return JNoun::Ptr(new JArray<T>(size == 1 ? Dimensions(0) : Dimensions(1, size), vec));
+    return JNoun::Ptr(new JArray<T>(Dimensions(1, size), vec));
   }
 };
 
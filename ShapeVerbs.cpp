@@ -1,12 +1,19 @@
 #include "ShapeVerbs.hpp"
+#include "JRagged.hpp"
 
 namespace J {
 
 JNoun::Ptr ShapeVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& arg) const { 
   Dimensions dims(arg.get_dims());
-  shared_ptr<vector<JInt> > v(new vector<JInt>(dims.begin(), dims.end()));
-  
-  return JNoun::Ptr(new JArray<JInt>(Dimensions(1, v->size()), v));
+  Dimensions::iter largest(std::max_element(dims.begin(), dims.end()));
+
+  if (largest != dims.end() && narrowest_int_type(0, *largest) == j_value_type_int64) {
+    JBuffer<JInt64>::Ptr v(JBuffer<JInt64>::InstantiateCopy(dims.begin(), dims.end()));
+    return JNoun::Ptr(new JArray<JInt64>(Dimensions(1, dims.get_rank()), v));
+  }
+
+  JBuffer<JInt>::Ptr v(JBuffer<JInt>::InstantiateCopy(dims.begin(), dims.end()));
+  return JNoun::Ptr(new JArray<JInt>(Dimensions(1, dims.get_rank()), v));
 }
 
 JNoun::Ptr ShapeVerb::DyadOp::operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const { 
@@ -15,40 +22,42 @@ JNoun::Ptr ShapeVerb::DyadOp::operator()(JMachine::Ptr, const JNoun& larg, const
 
 template <typename T>
 JNoun::Ptr ShapeDyadOp<T>::operator()(const JArray<T>& rarg, const JNoun& noun) const { 
-  JArray<JInt> larg(require_type<JInt>(noun));
+  JArray<JInt64> larg(require_type<JInt64>(noun));
   Dimensions from_larg(larg.is_scalar() ? 
 		       Dimensions(1, *(larg.begin())) : 
-		       Dimensions(larg.get_content()));
+		       Dimensions::from_range(larg.begin(), larg.end()));
   
   Dimensions final_dims(from_larg + rarg.get_dims().suffix(-1));
-  int rarg_number_of_elems = rarg.get_dims().number_of_elems();
+  JSize rarg_number_of_elems = rarg.get_dims().number_of_elems();
   
   if (final_dims.number_of_elems() != 0 && rarg_number_of_elems == 0) {
     throw JIllegalDimensionsException("Must have more than zero elements in input, when wanted in output.");
   }
+
+  if (rarg.get_progression() && final_dims.number_of_elems() <= rarg_number_of_elems) {
+    return JNoun::Ptr(new JArray<T>(rarg.slice(final_dims, 0)));
+  }
   
-  shared_ptr<vector<T> > container(new vector<T>(final_dims.number_of_elems(), 
-						 JTypeTrait<T>::base_elem()));
+  typename JBuffer<T>::Ptr container(JBuffer<T>::Instantiate(final_dims.number_of_elems()));
   
   if (rarg_number_of_elems != 0) {
-    typename vector<T>::iterator out_iter(container->begin());
-    typename vector<T>::iterator out_end(container->end());
+    typename JBuffer<T>::iterator out_iter(container->begin());
+    typename JBuffer<T>::iterator out_end(container->end());
     
-    while(distance(out_iter, out_end) >= rarg_number_of_elems) {
-      copy(rarg.begin(), rarg.end(), out_iter);
-      advance(out_iter, rarg_number_of_elems);
+    while(std::distance(out_iter, out_end) >= rarg_number_of_elems) {
+      std::copy(rarg.begin(), rarg.end(), out_iter);
+      std::advance(out_iter, rarg_number_of_elems);
     }
     
-    int distance_left(distance(out_iter, out_end));
-    copy(rarg.begin(), rarg.begin() + distance_left, out_iter);
+    JSize distance_left(std::distance(out_iter, out_end));
+    std::copy(rarg.begin(), rarg.begin() + distance_left, out_iter);
   }
   return JNoun::Ptr(new JArray<T>(final_dims, container));
 }
 
 template <typename T>
 JNoun::Ptr RavelOp<T>::operator()(const JArray<T>& arg) const {
-  return JNoun::Ptr(new JArray<T>(Dimensions(1, arg.get_dims().number_of_elems()), 
-				  arg.get_content()));
+  return JNoun::Ptr(new JArray<T>(arg.slice(Dimensions(1, arg.get_dims().number_of_elems()), 0)));
 }
 
 JNoun::Ptr RavelAppendVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& arg) const { 
@@ -81,6 +90,8 @@ JNoun::Ptr RazeLinkVerb::MonadOp::operator()(JMachine::Ptr m, const JNoun& arg)
   } 
   
   const JArray<JBox>& box_arr = static_cast<const JArray<JBox>&>(arg);
+  JNoun::Ptr flat(flat_raze(box_arr));
+  if (flat) return flat;
 
   typedef J::Aggregates::get_boxed_content<JArray<JBox>::iter> get_boxed;
   get_boxed::result_type content_iters(get_boxed()(box_arr.begin(), box_arr.end()));
@@ -89,8 +100,58 @@ JNoun::Ptr RazeLinkVerb::MonadOp::operator()(JMachine::Ptr m, const JNoun& arg)
 }
 
 JNoun::Ptr RazeLinkVerb::DyadOp::operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
+  JNoun::Ptr flat(flat_link(larg, rarg));
+  if (flat) return flat;
+
   return RavelAppendVerb()(m, *LessBoxVerb()(m, larg), 
 			   rarg.get_value_type() == j_value_type_box ? rarg : *LessBoxVerb()(m, rarg));
 }
 
+JNoun::Ptr TransposeVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  vector<int> axes(arg.get_rank());
+  for (int i = 0; i < arg.get_rank(); ++i) {
+    axes[i] = arg.get_rank() - 1 - i;
+  }
+  return arg.transpose(axes);
+}
+
+JNoun::Ptr TransposeVerb::DyadOp::operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const {
+  JArray<JInt64> moved(require_type<JInt64>(larg));
+  int rank(rarg.get_rank());
+  vector<bool> is_moved(rank, false);
+  vector<int> tail;
+
+  for (JArray<JInt64>::iter i = moved.begin(); i != moved.end(); ++i) {
+    JInt64 axis(*i < 0 ? *i + rank : *i);
+    if (axis < 0 || axis >= rank || is_moved[axis]) {
+      throw JIllegalDimensionsException("Illegal axis given to transpose");
+    }
+    is_moved[axis] = true;
+    tail.push_back(axis);
+  }
+
+  vector<int> axes;
+  for (int i = 0; i < rank; ++i) {
+    if (!is_moved[i]) axes.push_back(i);
+  }
+  axes.insert(axes.end(), tail.begin(), tail.end());
+  return rarg.transpose(axes);
+}
+
+JNoun::Ptr ReverseRotateVerb::MonadOp::operator()(JMachine::Ptr, const JNoun& arg) const {
+  return arg.reverse();
+}
+
+JNoun::Ptr ReverseRotateVerb::DyadOp::operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const {
+  if (rarg.is_scalar() || rarg.get_dims()[0] == 0) return rarg.clone();
+
+  JSize items(rarg.get_dims()[0]);
+  JSize shift(require_type<JInt64>(larg).get_scalar_value() % items);
+  if (shift < 0) shift += items;
+  if (shift == 0) return rarg.clone();
+
+  JNoun::Ptr parts[2] = { rarg.subarray(shift, items), rarg.subarray(0, shift) };
+  return J::Aggregates::concatenate_nouns(parts, parts + 2);
+}
+
 }
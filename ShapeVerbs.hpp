@@ -67,6 +67,34 @@ public:
 			DefaultDyad<DyadOp>::Instantiate(rank_infinity, rank_infinity, DyadOp())) {}
 };
 
+class TransposeVerb: public JVerb {
+  struct MonadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const;
+  };
+
+  struct DyadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const;
+  };
+
+public:
+  TransposeVerb(): JVerb(DefaultMonad<MonadOp>::Instantiate(rank_infinity, MonadOp()),
+			 DefaultDyad<DyadOp>::Instantiate(1, rank_infinity, DyadOp())) {}
+};
+
+class ReverseRotateVerb: public JVerb {
+  struct MonadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const;
+  };
+
+  struct DyadOp {
+    JNoun::Ptr operator()(JMachine::Ptr, const JNoun& larg, const JNoun& rarg) const;
+  };
+
+public:
+  ReverseRotateVerb(): JVerb(DefaultMonad<MonadOp>::Instantiate(rank_infinity, MonadOp()),
+			     DefaultDyad<DyadOp>::Instantiate(0, rank_infinity, DyadOp())) {}
+};
+
 }	
 
 #endif
@@ -2,6 +2,7 @@
 #define TRAINS_HPP
 
 #include "JVerbs.hpp"
+#include "JFusion.hpp"
 #include <functional>
 #include <numeric>
 #include <boost/shared_ptr.hpp>
@@ -12,11 +13,19 @@ using boost::shared_ptr;
 class Hook: public JVerb { 
   class MonadOp: public Monad {
     JVerb::Ptr verb0, verb1;
+    bool elementwise;
   public:
     MonadOp(JVerb::Ptr verb0, JVerb::Ptr verb1):
-      Monad(rank_infinity), verb0(verb0), verb1(verb1) {}
+      Monad(rank_infinity), verb0(verb0), verb1(verb1),
+      elementwise(verb0->is_dyad_elementwise() && verb1->is_monad_elementwise()) {}
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const { 
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, arg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun((*verb1)(m, arg));
       JNoun::Ptr resnoun((*verb0)(m, arg, *noun));
       return resnoun;
@@ -25,11 +34,19 @@ class Hook: public JVerb {
   
   class DyadOp: public Dyad  {
     JVerb::Ptr verb0, verb1;
+    bool elementwise;
   public:
     DyadOp(JVerb::Ptr verb0, JVerb::Ptr verb1):
-      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1) {}
+      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1),
+      elementwise(verb0->is_dyad_elementwise() && verb1->is_monad_elementwise()) {}
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const {
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, larg, rarg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun((*verb1)(m, rarg));
       JNoun::Ptr resnoun((*verb0)(m, larg, *noun));
       return resnoun;
@@ -46,17 +63,25 @@ class BoundHook: public JVerb {
   class MonadOp: public Monad { 
     JVerb::Ptr verb0, verb1;
     JNoun::Ptr noun;
+    bool elementwise;
   public:
     static Ptr Instantiate(JNoun::Ptr noun, JVerb::Ptr verb0, JVerb::Ptr verb1) {
       return Ptr(new MonadOp(noun, verb0, verb1));
     }
 
     MonadOp(JNoun::Ptr noun, JVerb::Ptr verb0, JVerb::Ptr verb1):
-      Monad(rank_infinity), verb0(verb0), verb1(verb1), noun(noun) {}
+      Monad(rank_infinity), verb0(verb0), verb1(verb1), noun(noun),
+      elementwise(noun->is_scalar() && verb0->is_dyad_elementwise() && verb1->is_monad_elementwise()) {}
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const {
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, arg));
+	if (fused) return fused;
+      }
       JNoun::Ptr res0((*verb1)(m, arg));
-      JNoun::Ptr res1((*verb0)(m, *noun, *res0));
+      JNoun::Ptr res1(verb0->apply_owned(m, noun, res0));
       return res1;
     }
   };
@@ -64,17 +89,25 @@ class BoundHook: public JVerb {
   class DyadOp: public Dyad {
     JVerb::Ptr verb0, verb1;
     JNoun::Ptr noun;
+    bool elementwise;
   public:
     static Ptr Instantiate(JNoun::Ptr noun, JVerb::Ptr verb0, JVerb::Ptr verb1) {
       return Ptr(new DyadOp(noun, verb0, verb1));
     }
 
     DyadOp(JNoun::Ptr noun, JVerb::Ptr verb0, JVerb::Ptr verb1):
-      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1), noun(noun) {}
+      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1), noun(noun),
+      elementwise(noun->is_scalar() && verb0->is_dyad_elementwise() && verb1->is_dyad_elementwise()) {}
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, larg, rarg));
+	if (fused) return fused;
+      }
       JNoun::Ptr res0((*verb1)(m, larg, rarg));
-      JNoun::Ptr res1((*verb0)(m, *noun, *res0));
+      JNoun::Ptr res1(verb0->apply_owned(m, noun, res0));
       return res1;
     }
   };
@@ -89,36 +122,54 @@ public:
 class Fork: public JVerb { 
   class MonadOp: public Monad { 
     JVerb::Ptr verb0, verb1, verb2;
+    bool elementwise;
   public:
     static Ptr Instantiate(JVerb::Ptr verb0, JVerb::Ptr verb1, JVerb::Ptr verb2) {
       return Ptr(new MonadOp(verb0, verb1, verb2));
     }
 
     MonadOp(JVerb::Ptr verb0, JVerb::Ptr verb1, JVerb::Ptr verb2):
-      Monad(rank_infinity), verb0(verb0), verb1(verb1), verb2(verb2) {} 
+      Monad(rank_infinity), verb0(verb0), verb1(verb1), verb2(verb2),
+      elementwise(verb0->is_monad_elementwise() && verb1->is_dyad_elementwise() &&
+		  verb2->is_monad_elementwise()) {} 
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const { 
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, arg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun0((*verb0)(m, arg));
       JNoun::Ptr noun1((*verb2)(m, arg));
-      JNoun::Ptr resnoun((*verb1)(m, *noun0, *noun1));
+      JNoun::Ptr resnoun(verb1->apply_owned(m, noun0, noun1));
       return resnoun;
     }
   };
 
   class DyadOp: public Dyad { 
     JVerb::Ptr verb0, verb1, verb2; 
+    bool elementwise;
   public:
     static Ptr Instantiate(JVerb::Ptr verb0, JVerb::Ptr verb1, JVerb::Ptr verb2) {
       return Ptr(new DyadOp(verb0, verb1, verb2));
     }
 
     DyadOp(JVerb::Ptr verb0, JVerb::Ptr verb1, JVerb::Ptr verb2): 
-      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1), verb2(verb2) {}
+      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1), verb2(verb2),
+      elementwise(verb0->is_dyad_elementwise() && verb1->is_dyad_elementwise() &&
+		  verb2->is_dyad_elementwise()) {}
     
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, larg, rarg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun0((*verb0)(m, larg, rarg));
       JNoun::Ptr noun1((*verb2)(m, larg, rarg));
-      JNoun::Ptr resnoun((*verb1)(m, *noun0, *noun1));
+      JNoun::Ptr resnoun(verb1->apply_owned(m, noun0, noun1));
       return resnoun;
     }
   };
@@ -132,27 +183,43 @@ public:
 class CappedFork: public JVerb {
   class MonadOp: public Monad { 
     JVerb::Ptr verb0, verb1;
+    bool elementwise;
   public:
     MonadOp(JVerb::Ptr verb0, JVerb::Ptr verb1): 
-      Monad(rank_infinity), verb0(verb0), verb1(verb1) {}
+      Monad(rank_infinity), verb0(verb0), verb1(verb1),
+      elementwise(verb0->is_monad_elementwise() && verb1->is_monad_elementwise()) {}
+
+    bool is_elementwise() const { return elementwise; }
 
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& arg) const {
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, arg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun0((*verb1)(m, arg));
-      JNoun::Ptr resnoun((*verb0)(m, *noun0));
+      JNoun::Ptr resnoun(verb0->apply_owned(m, noun0));
       return resnoun;
     }
   };
 
   class DyadOp: public Dyad { 
     JVerb::Ptr verb0, verb1;
+    bool elementwise;
 
   public:
     DyadOp(JVerb::Ptr verb0, JVerb::Ptr verb1):
-      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1) {}
+      Dyad(rank_infinity, rank_infinity), verb0(verb0), verb1(verb1),
+      elementwise(verb0->is_monad_elementwise() && verb1->is_dyad_elementwise()) {}
       
+    bool is_elementwise() const { return elementwise; }
+
     JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const { 
+      if (elementwise) {
+	JNoun::Ptr fused(blockwise_apply(*this, m, larg, rarg));
+	if (fused) return fused;
+      }
       JNoun::Ptr noun0((*verb1)(m, larg, rarg));
-      JNoun::Ptr resnoun((*verb0)(m, *noun0));
+      JNoun::Ptr resnoun(verb0->apply_owned(m, noun0));
       return resnoun;
     }
   };
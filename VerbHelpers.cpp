@@ -56,13 +56,13 @@ void  DimensionCounter::increment(int pos)  {
   }
 }
 
-DimensionCounter::DimensionCounter(const vector<int>& ref): reference(ref), 
+DimensionCounter::DimensionCounter(const vector<JSize>& ref): reference(ref), 
 							    current_count(reference.size()),
 							    suffix_array(reference.size()),
 							    turned_around(false) {
   for (int i = 0, len = reference.size(); i < len; ++i) {
     suffix_array[i] = std::abs(accumulate(reference.begin() + i + 1, reference.end(), 
-					  1, std::multiplies<int>()));
+					  JSize(1), std::multiplies<JSize>()));
     if (reference[i] == 0) turned_around = true;
     if (reference[i] < 0) current_count[i] = -(reference[i] + 1);
   }
@@ -73,8 +73,8 @@ DimensionCounter& DimensionCounter::operator++() {
   return *this;
 }
   
-int DimensionCounter::operator*() const {
-  int res = 0;
+JSize DimensionCounter::operator*() const {
+  JSize res = 0;
   for (int i = 0, len = current_count.size(); i < len; ++i) {
     res += current_count[i]*suffix_array[i];
   }
@@ -82,6 +82,26 @@ int DimensionCounter::operator*() const {
   return res;
 }
 
+JNoun::Ptr progression_result(const Dimensions& dims, const JProgression& progression, 
+			      j_value_type common_type) {
+  JInt64 overflow(0);
+  JInt64 last(progression.start);
+  if (dims.number_of_elems() > 0) {
+    last = CheckedAdd::apply(progression.start, 
+			     CheckedMultiply::apply(dims.number_of_elems() - 1, progression.step, overflow), 
+			     overflow);
+  }
+  if (overflow < 0) return JNoun::Ptr();
+
+  // A range that outgrows int becomes float, as dense int arithmetic does, but stays lazy.
+  j_value_type needed(narrowest_int_type(std::min(progression.start, last), 
+					 std::max(progression.start, last)));
+  if (needed > std::max(common_type, j_value_type_int)) {
+    return progression_array(dims, progression, j_value_type_float);
+  }
+  return progression_array(dims, progression, std::max(common_type, needed));
+}
+
 JArray<JInt> require_ints(const JNoun& noun) {
   if (noun.get_value_type() == j_value_type_int) {
     return static_cast<const JArray<JInt> &>(noun);
@@ -6,6 +6,7 @@
 #include "JTypes.hpp"
 #include "Aggregates.hpp"
 #include "utils.hpp"
+#include "JSimd.hpp"
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include <cmath>
@@ -16,6 +17,7 @@
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/foreach.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 
 namespace J {
 using boost::shared_ptr;
@@ -27,6 +29,26 @@ OperationIteratorBase::Ptr get_operation_iterator(const JNoun& arg, const Dimens
 						  int output_rank);
   
 Dimensions find_frame(int lrank, int rrank, const Dimensions& larg, const Dimensions& rarg);
+
+inline bool is_owned(const JNoun::Ptr& noun) {
+  return noun->is_unique() && noun->has_unique_content();
+}
+
+template <typename T>
+intrusive_ptr<JArray<T> > reusable_array(const JNoun* candidate, const Dimensions& d) {
+  if (!candidate || candidate->get_value_type() != JTypeTrait<T>::value_type || candidate->get_dims() != d) {
+    return intrusive_ptr<JArray<T> >();
+  }
+  return intrusive_ptr<JArray<T> >(new JArray<T>(static_cast<const JArray<T>&>(*candidate)));
+}
+
+template <typename T>
+intrusive_ptr<JArray<T> > result_array(const Dimensions& d, const JNoun* lcandidate, const JNoun* rcandidate = 0) {
+  intrusive_ptr<JArray<T> > res(reusable_array<T>(lcandidate, d));
+  if (!res) res = reusable_array<T>(rcandidate, d);
+  if (!res) res = allocated_array<T>(d);
+  return res;
+}
   
 template <typename Op>
 JNoun::Ptr dyadic_apply(int lrank, int rrank, 
@@ -52,22 +74,451 @@ JNoun::Ptr dyadic_apply(int lrank, int rrank,
 }
 
 
+template <typename Arg>
+struct BadScalarMonadOp: std::unary_function<Arg, Arg> { 
+  Arg operator()(Arg) {
+    throw JIllegalValueTypeException();
+  }
+};
+
+template <typename Arg>
+struct BadScalarDyadOp: std::binary_function<Arg, Arg, Arg> { 
+  Arg operator()(Arg, Arg) {
+    throw JIllegalValueTypeException();
+  }
+};  
+
+template <template <typename> class Op, typename To = JInt>
+struct PromotedScalarMonadOp: std::unary_function<JBool, typename Op<To>::result_type> {
+  typename Op<To>::result_type operator()(JBool arg) const {
+    return Op<To>()(ConvertType<JBool, To>()(arg));
+  }
+};
+
+template <template <typename> class Op, typename To = JInt>
+struct PromotedScalarDyadOp: std::binary_function<JBool, JBool, typename Op<To>::result_type> {
+  typename Op<To>::result_type operator()(JBool larg, JBool rarg) const {
+    return Op<To>()(ConvertType<JBool, To>()(larg), ConvertType<JBool, To>()(rarg));
+  }
+};
+
+template <typename WordOp>
+struct BitwiseMonadOp: std::unary_function<JBool, JBool> {
+  JBool operator()(JBool arg) const {
+    return (WordOp()(JBitWord(arg)) & 1) != 0;
+  }
+};
+
+template <typename WordOp>
+struct BitwiseDyadOp: std::binary_function<JBool, JBool, JBool> {
+  JBool operator()(JBool larg, JBool rarg) const {
+    return (WordOp()(JBitWord(larg), JBitWord(rarg)) & 1) != 0;
+  }
+};
+
+struct BitNot { JBitWord operator()(JBitWord a) const { return ~a; } };
+struct BitAnd { JBitWord operator()(JBitWord a, JBitWord b) const { return a & b; } };
+struct BitOr { JBitWord operator()(JBitWord a, JBitWord b) const { return a | b; } };
+struct BitLess { JBitWord operator()(JBitWord a, JBitWord b) const { return ~a & b; } };
+struct BitMore { JBitWord operator()(JBitWord a, JBitWord b) const { return a & ~b; } };
+struct BitLessequal { JBitWord operator()(JBitWord a, JBitWord b) const { return ~a | b; } };
+struct BitMoreequal { JBitWord operator()(JBitWord a, JBitWord b) const { return a | ~b; } };
+
+template <typename Iterator, typename OutIterator, typename Op>
+void scalar_transform(Iterator begin, Iterator end, OutIterator out, Op op, const void*) {
+  std::transform(begin, end, out, op);
+}
+
+template <typename Op, typename WordOp>
+void scalar_transform(JBitIterator begin, JBitIterator end, JBitIterator out, Op, 
+		      const BitwiseMonadOp<WordOp>*) {
+  transform_bits(begin, end, out, WordOp());
+}
+
+template <typename Iterator, typename OutIterator, typename Op>
+void scalar_transform(Iterator begin1, Iterator end1, Iterator begin2, OutIterator out, Op op, const void*) {
+  std::transform(begin1, end1, begin2, out, op);
+}
+
+// Which vector kernel, if any, computes an operation; specialised next to the operations.
+template <typename Op>
+struct SimdOpTrait {
+  static const simd_op value = simd_op_none;
+};
+
+template <typename T, typename R, typename Op>
+void scalar_transform(T* begin1, T* end1, T* begin2, R* out, Op op, const void*) {
+  if (!simd_transform(SimdOpTrait<Op>::value, begin1, begin2, out, end1 - begin1)) {
+    std::transform(begin1, end1, begin2, out, op);
+  }
+}
+
+template <typename T, typename Op>
+void scalar_transform(T* begin1, T* end1, T* begin2, JBitIterator out, Op op, const void*) {
+  if (!simd_transform(SimdOpTrait<Op>::value, begin1, begin2, out, end1 - begin1)) {
+    std::transform(begin1, end1, begin2, out, op);
+  }
+}
+
+template <typename Op, typename WordOp>
+void scalar_transform(JBitIterator begin1, JBitIterator end1, JBitIterator begin2, JBitIterator out, Op,
+		      const BitwiseDyadOp<WordOp>*) {
+  transform_bits(begin1, end1, begin2, out, WordOp());
+}
+
+const std::size_t checked_block_size = 1024;
+
+template <typename T>
+T wrapping_add(T a, T b) {
+  typedef typename boost::make_unsigned<T>::type U;
+  return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+}
+
+template <typename T>
+T wrapping_subtract(T a, T b) {
+  typedef typename boost::make_unsigned<T>::type U;
+  return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+}
+
+struct CheckedAdd {
+  template <typename T>
+  static T apply(T a, T b, T& overflow) {
+    T res(wrapping_add(a, b));
+    overflow |= (a ^ res) & (b ^ res);
+    return res;
+  }
+
+  static JFloat apply_float(JFloat a, JFloat b) { return a + b; }
+};
+
+struct CheckedSubtract {
+  template <typename T>
+  static T apply(T a, T b, T& overflow) {
+    T res(wrapping_subtract(a, b));
+    overflow |= (a ^ b) & (a ^ res);
+    return res;
+  }
+
+  static JFloat apply_float(JFloat a, JFloat b) { return a - b; }
+};
+
+struct CheckedMultiply {
+  static JInt apply(JInt a, JInt b, JInt& overflow) {
+    JInt64 product(static_cast<JInt64>(a) * b);
+    JInt res(static_cast<JInt>(product));
+    overflow |= -static_cast<JInt>(product != res);
+    return res;
+  }
+
+  static JInt64 apply(JInt64 a, JInt64 b, JInt64& overflow) {
+    JInt64 res;
+    overflow |= -static_cast<JInt64>(__builtin_mul_overflow(a, b, &res));
+    return res;
+  }
+
+  static JFloat apply_float(JFloat a, JFloat b) { return a * b; }
+};
+
+template <>
+struct SimdOpTrait<CheckedAdd> {
+  static const simd_op value = simd_op_add;
+};
+
+template <>
+struct SimdOpTrait<CheckedSubtract> {
+  static const simd_op value = simd_op_subtract;
+};
+
+template <>
+struct SimdOpTrait<CheckedMultiply> {
+  static const simd_op value = simd_op_multiply;
+};
+
+template <typename T, typename Kernel>
+struct OverflowCheckedDyadOp: std::binary_function<T, T, T> {
+  T operator()(T larg, T rarg) const {
+    T overflow(0);
+    return Kernel::apply(larg, rarg, overflow);
+  }
+};
+
+template <typename Kernel, typename T>
+bool checked_block(const T* lhs, const T* rhs, T* out, std::size_t n) {
+  bool overflowed;
+  if (simd_checked_transform(SimdOpTrait<Kernel>::value, lhs, rhs, out, n, overflowed)) return overflowed;
+
+  T overflow(0);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = Kernel::apply(lhs[i], rhs[i], overflow);
+  }
+  return overflow < 0;
+}
+
+template <typename Kernel, typename T>
+void float_block(const T* lhs, const T* rhs, JFloat* out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = Kernel::apply_float(lhs[i], rhs[i]);
+  }
+}
+
+template <typename T>
+class ContiguousBlocks {
+  const T* lhs;
+  const T* rhs;
+
+public:
+  ContiguousBlocks(const T* lhs, const T* rhs): lhs(lhs), rhs(rhs) {}
+
+  void next(std::size_t n, const T*& lblock, const T*& rblock, T*, T*) {
+    lblock = lhs;
+    rblock = rhs;
+    lhs += n;
+    rhs += n;
+  }
+};
+
+// Arguments agreeing by frame prefix: each element of the shorter argument applies to a
+// run of span contiguous elements of the longer one, and a scalar to a single run. The
+// longer argument is passed through as is, while the shorter one is spread into scratch
+// space, which is left alone for as long as the runs it already holds continue.
+template <typename T>
+class BroadcastBlocks {
+  const T* cells;
+  const T* repeated;
+  JSize span, position, filled_run, filled_length;
+  bool repeated_left;
+
+public:
+  BroadcastBlocks(const T* cells, const T* repeated, JSize span, bool repeated_left): 
+    cells(cells), repeated(repeated), span(span), position(0), filled_run(-1), filled_length(0),
+    repeated_left(repeated_left) {}
+
+  void next(std::size_t n, const T*& lblock, const T*& rblock, T* lscratch, T* rscratch) {
+    T* scratch(repeated_left ? lscratch : rscratch);
+    JSize run(position / span), end(position + n);
+    if (run != filled_run || static_cast<JSize>(n) > filled_length || (end - 1) / span != run) {
+      T* out(scratch);
+      for (JSize from = position; from < end; ++run) {
+	JSize to(std::min(end, (run + 1) * span));
+	std::fill(out, out + (to - from), repeated[run]);
+	out += to - from;
+	from = to;
+      }
+      bool single_run(position / span == (end - 1) / span);
+      filled_run = single_run ? position / span : -1;
+      filled_length = single_run ? n : 0;
+    }
+
+    (repeated_left ? lblock : rblock) = scratch;
+    (repeated_left ? rblock : lblock) = cells + position;
+    position = end;
+  }
+};
+
+template <typename Kernel, typename T, typename Blocks>
+JNoun::Ptr checked_transform(const Dimensions& d, Blocks blocks, 
+			     const JNoun* lreusable, const JNoun* rreusable) {
+  intrusive_ptr<JArray<T> > res(result_array<T>(d, lreusable, rreusable));
+  T* out(res->begin());
+  JSize n(d.number_of_elems());
+  T lscratch[checked_block_size], rscratch[checked_block_size], block[checked_block_size];
+  const T* lblock;
+  const T* rblock;
+
+  for (JSize done = 0; done < n; done += checked_block_size) {
+    std::size_t len(std::min<JSize>(checked_block_size, n - done));
+    blocks.next(len, lblock, rblock, lscratch, rscratch);
+
+    if (checked_block<Kernel>(lblock, rblock, block, len)) {
+      intrusive_ptr<JArray<JFloat> > promoted(allocated_array<JFloat>(d));
+      JFloat* float_out(std::copy(out, out + done, promoted->begin()));
+
+      for (float_block<Kernel>(lblock, rblock, float_out, len), done += len; done < n; done += len) {
+	len = std::min<JSize>(checked_block_size, n - done);
+	blocks.next(len, lblock, rblock, lscratch, rscratch);
+	float_block<Kernel>(lblock, rblock, promoted->begin() + done, len);
+      }
+      return promoted;
+    }
+    std::copy(block, block + len, out + done);
+  }
+
+  return res;
+}
+
+template <typename T, typename Op>
+JNoun::Ptr scalar_dyadic_result(const JArray<T>& larg, const JArray<T>& rarg, 
+				const JNoun* lreusable, const JNoun* rreusable, Op op, const void*) {
+  typedef typename Op::result_type result_type;
+  if (larg.is_scalar()) return scalar_noun<result_type>(op(*larg.begin(), *rarg.begin()));
+
+  intrusive_ptr<JArray<result_type> > res(result_array<result_type>(larg.get_dims(), lreusable, rreusable));
+  scalar_transform(larg.begin(), larg.end(), rarg.begin(), res->begin(), op, static_cast<Op*>(0));
+  return res;
+}
+
+template <typename T, typename Op, typename Kernel>
+JNoun::Ptr scalar_dyadic_result(const JArray<T>& larg, const JArray<T>& rarg, 
+				const JNoun* lreusable, const JNoun* rreusable, Op, 
+				const OverflowCheckedDyadOp<T, Kernel>*) {
+  if (larg.is_scalar()) {
+    T overflow(0);
+    T value(Kernel::apply(*larg.begin(), *rarg.begin(), overflow));
+    if (overflow < 0) return scalar_noun(Kernel::apply_float(*larg.begin(), *rarg.begin()));
+    return scalar_noun(value);
+  }
+
+  return checked_transform<Kernel, T>(larg.get_dims(), ContiguousBlocks<T>(larg.begin(), rarg.begin()),
+				      lreusable, rreusable);
+}
+
+template <typename T, typename Op>
+JNoun::Ptr scalar_dyadic_result(const Dimensions& frame, OperationScalarIterator<T> liter, 
+				OperationScalarIterator<T> riter, const JNoun* lreusable, 
+				const JNoun* rreusable, Op op) {
+  typedef typename Op::result_type result_type;
+  intrusive_ptr<JArray<result_type> > res(result_array<result_type>(frame, lreusable, rreusable));
+      
+  for(typename JArray<result_type>::iter output(res->begin()), output_end(res->end()); output != output_end; 
+      ++output, ++liter, ++riter) {
+    *output = op(*liter, *riter);
+  }
+      
+  return res;
+}
+
+template <typename T>
+BroadcastBlocks<T> broadcast_blocks(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg) {
+  bool repeated_left(larg.get_dims() != frame);
+  const JArray<T>& repeated(repeated_left ? larg : rarg);
+  return BroadcastBlocks<T>((repeated_left ? rarg : larg).begin(), repeated.begin(), 
+			    frame.number_of_elems() / repeated.get_dims().number_of_elems(), repeated_left);
+}
+
+template <typename T, typename Op>
+JNoun::Ptr scalar_dyadic_result(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+				const JNoun* lreusable, const JNoun* rreusable, Op op, const void*) {
+  typedef typename Op::result_type result_type;
+  intrusive_ptr<JArray<result_type> > res(result_array<result_type>(frame, lreusable, rreusable));
+  typename JArray<result_type>::iter out(res->begin());
+  BroadcastBlocks<T> blocks(broadcast_blocks(frame, larg, rarg));
+  JSize n(frame.number_of_elems());
+  T lscratch[checked_block_size], rscratch[checked_block_size];
+  const T* lblock;
+  const T* rblock;
+
+  for (JSize done = 0; done < n; done += checked_block_size) {
+    std::size_t len(std::min<JSize>(checked_block_size, n - done));
+    blocks.next(len, lblock, rblock, lscratch, rscratch);
+    scalar_transform(lblock, lblock + len, rblock, out + done, op, static_cast<Op*>(0));
+  }
+  return res;
+}
+
+// Boxes cannot fill scratch space, having no default value.
+template <typename Op>
+JNoun::Ptr scalar_dyadic_result(const Dimensions& frame, const JArray<JBox>& larg, const JArray<JBox>& rarg, 
+				const JNoun* lreusable, const JNoun* rreusable, Op op, const void*) {
+  return scalar_dyadic_result(frame, OperationScalarIterator<JBox>(larg, frame), 
+			      OperationScalarIterator<JBox>(rarg, frame), lreusable, rreusable, op);
+}
+
+template <typename T, typename Op, typename Kernel>
+JNoun::Ptr scalar_dyadic_result(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+				const JNoun* lreusable, const JNoun* rreusable, Op, 
+				const OverflowCheckedDyadOp<T, Kernel>*) {
+  return checked_transform<Kernel, T>(frame, broadcast_blocks(frame, larg, rarg), lreusable, rreusable);
+}
+
+template <typename T, typename Result>
+struct narrowed_storage {
+  typedef Result type;
+};
+
+template <>
+struct narrowed_storage<JInt8, JInt> {
+  typedef JInt8 type;
+};
+
+template <>
+struct narrowed_storage<JInt16, JInt> {
+  typedef JInt16 type;
+};
+
+template <typename Iterator, typename Op>
+class MonadicResultIterator {
+  Iterator iter;
+  mutable Op op;
+
+public:
+  MonadicResultIterator(Iterator iter): iter(iter), op() {}
+
+  typename Op::result_type operator*() const { return op(*iter); }
+  MonadicResultIterator& operator++() { ++iter; return *this; }
+};
+
+template <typename LIterator, typename RIterator, typename Op>
+class DyadicResultIterator {
+  LIterator liter;
+  RIterator riter;
+  mutable Op op;
+
+public:
+  DyadicResultIterator(LIterator liter, RIterator riter): liter(liter), riter(riter), op() {}
+
+  typename Op::result_type operator*() const { return op(*liter, *riter); }
+  DyadicResultIterator& operator++() { ++liter; ++riter; return *this; }
+};
+
+template <typename Narrow, typename Iterator>
+JNoun::Ptr narrowed_result(const Dimensions& d, Iterator input, 
+			   const JNoun* lreusable, const JNoun* rreusable = 0) {
+  intrusive_ptr<JArray<Narrow> > res(result_array<Narrow>(d, lreusable, rreusable));
+
+  for (typename JArray<Narrow>::iter out(res->begin()), end(res->end()); out != end; ++out, ++input) {
+    JInt val(*input);
+    if (val < std::numeric_limits<Narrow>::min() || val > std::numeric_limits<Narrow>::max()) {
+      intrusive_ptr<JArray<JInt> > wide(allocated_array<JInt>(d));
+      JArray<JInt>::iter wide_out(std::copy(res->begin(), out, wide->begin())), wide_end(wide->end());
+      for (; wide_out != wide_end; ++wide_out, ++input) {
+	*wide_out = *input;
+      }
+      return wide;
+    }
+    *out = static_cast<Narrow>(val);
+  }
+
+  return res;
+}
+
 template <template <typename> class Op> 
 struct scalar_monadic_apply {
   template <typename T>
   struct Impl {
-    typedef Op<T> our_op;
+    typedef Op<typename JKernelType<T>::type> our_op;
     typedef typename our_op::result_type result_type;
-    typedef typename our_op::argument_type argument_type;
+    typedef typename narrowed_storage<T, result_type>::type storage_type;
     
     JNoun::Ptr
-    operator()(const JArray<argument_type>& arg) {
-      Dimensions d(arg.get_dims());
-      shared_ptr<vector<result_type> > v
-	(new vector<result_type>(d.number_of_elems(), JTypeTrait<result_type>::base_elem()));
-      transform(arg.begin(), arg.end(), v->begin(), our_op());
-      
-      return JNoun::Ptr(new JArray<result_type>(d, v));
+    operator()(const JArray<T>& arg, const JNoun* reusable) {
+      return apply(arg, reusable, static_cast<storage_type*>(0), static_cast<result_type*>(0));
+    }
+
+  private:
+    template <typename Result>
+    JNoun::Ptr apply(const JArray<T>& arg, const JNoun* reusable, Result*, Result*) {
+      if (arg.is_scalar()) return scalar_noun<result_type>(our_op()(*arg.begin()));
+
+      intrusive_ptr<JArray<result_type> > res(result_array<result_type>(arg.get_dims(), reusable));
+      scalar_transform(arg.begin(), arg.end(), res->begin(), our_op(), static_cast<our_op*>(0));
+      return res;
+    }
+
+    template <typename Storage, typename Result>
+    JNoun::Ptr apply(const JArray<T>& arg, const JNoun* reusable, Storage*, Result*) {
+      return narrowed_result<Storage>(arg.get_dims(), 
+				      MonadicResultIterator<typename JArray<T>::iter, our_op>(arg.begin()),
+				      reusable);
     }
   };
 
@@ -102,15 +553,15 @@ template <template <typename> class OpType>
 struct scalar_dyadic_apply {
   template <typename T>
   struct Impl {
-    JNoun::Ptr operator()(const JArray<T>& larg, const JArray<T>& rarg, JMachine::Ptr) const { 
-      typedef typename OpType<T>::result_type result_type;
-      typedef vector<result_type> res_vec;
-      
+    typedef OpType<typename JKernelType<T>::type> our_op;
+    typedef typename our_op::result_type result_type;
+    typedef typename narrowed_storage<T, result_type>::type storage_type;
+
+    JNoun::Ptr operator()(const JArray<T>& larg, const JArray<T>& rarg, JMachine::Ptr,
+			  const JNoun* lreusable, const JNoun* rreusable) const { 
       if (larg.get_dims() == rarg.get_dims()) {
-	Dimensions d(larg.get_dims());
-	shared_ptr<res_vec > v(new res_vec(d.number_of_elems(), JTypeTrait<result_type>::base_elem()));
-	transform(larg.begin(), larg.end(), rarg.begin(), v->begin(), OpType<T>());
-	return JNoun::Ptr(new JArray<result_type>(d, v));
+	return apply(larg, rarg, lreusable, rreusable, 
+		     static_cast<storage_type*>(0), static_cast<result_type*>(0));
       }
       
       Dimensions frame(find_frame(0, 0, larg.get_dims(), rarg.get_dims()));
@@ -119,21 +570,93 @@ struct scalar_dyadic_apply {
 	return JNoun::Ptr(new JArray<JInt>(frame));
       }
 
-      OperationScalarIterator<T> liter(larg, frame), riter(rarg, frame);
-      
-      shared_ptr<res_vec > v(new res_vec(frame.number_of_elems(), JTypeTrait<result_type>::base_elem()));
-      
-      OpType<T> op;
-      for(typename res_vec::iterator output(v->begin()), output_end(v->end()); output != output_end; 
-	  ++output, ++liter, ++riter) {
-	*output = op(*liter, *riter);
-      }
-      
-      return JNoun::Ptr(new JArray<result_type>(frame, v));
+      return apply_framed(frame, larg, rarg, lreusable, rreusable, 
+			  static_cast<storage_type*>(0), static_cast<result_type*>(0));
+    }
+
+  private:
+    template <typename Result>
+    JNoun::Ptr apply(const JArray<T>& larg, const JArray<T>& rarg, 
+		     const JNoun* lreusable, const JNoun* rreusable, Result*, Result*) const {
+      return scalar_dyadic_result(larg, rarg, lreusable, rreusable, our_op(), static_cast<our_op*>(0));
+    }
+
+    template <typename Storage, typename Result>
+    JNoun::Ptr apply(const JArray<T>& larg, const JArray<T>& rarg, 
+		     const JNoun* lreusable, const JNoun* rreusable, Storage*, Result*) const {
+      typedef typename JArray<T>::iter iter;
+      return narrowed_result<Storage>(larg.get_dims(), 
+				      DyadicResultIterator<iter, iter, our_op>(larg.begin(), rarg.begin()),
+				      lreusable, rreusable);
+    }
+
+    template <typename Result>
+    JNoun::Ptr apply_framed(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+			    const JNoun* lreusable, const JNoun* rreusable, Result*, Result*) const {
+      return broadcast(frame, larg, rarg, lreusable, rreusable, static_cast<typename JArray<T>::iter*>(0));
+    }
+
+    template <typename Storage, typename Result>
+    JNoun::Ptr apply_framed(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+			    const JNoun* lreusable, const JNoun* rreusable, Storage*, Result*) const {
+      typedef OperationScalarIterator<T> iter;
+      return narrowed_result<Storage>(frame, DyadicResultIterator<iter, iter, our_op>(iter(larg, frame), 
+										      iter(rarg, frame)),
+				      lreusable, rreusable);
+    }
+
+    JNoun::Ptr broadcast(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+			 const JNoun* lreusable, const JNoun* rreusable, T**) const {
+      return scalar_dyadic_result(frame, larg, rarg, lreusable, rreusable, our_op(), static_cast<our_op*>(0));
+    }
+
+    template <typename Iterator>
+    JNoun::Ptr broadcast(const Dimensions& frame, const JArray<T>& larg, const JArray<T>& rarg, 
+			 const JNoun* lreusable, const JNoun* rreusable, Iterator*) const {
+      return scalar_dyadic_result(frame, OperationScalarIterator<T>(larg, frame), 
+				  OperationScalarIterator<T>(rarg, frame), lreusable, rreusable, our_op());
     }
   };
 };
 
+template <template <typename> class Op>
+struct ProgressionRule {
+  static bool with_scalar(const JProgression&, JInt64, bool, JProgression*) { return false; }
+  static bool with_progression(const JProgression&, const JProgression&, JProgression*) { return false; }
+};
+
+JNoun::Ptr progression_result(const Dimensions& dims, const JProgression& progression, 
+			      j_value_type common_type);
+
+template <template <typename> class Op>
+JNoun::Ptr progression_dyad(const JNoun& larg, const JNoun& rarg) {
+  optional<JProgression> lprog(larg.get_progression()), rprog(rarg.get_progression());
+  if (!lprog && !rprog) return JNoun::Ptr();
+  if (!is_integer_type(larg.get_value_type()) || !is_integer_type(rarg.get_value_type())) {
+    return JNoun::Ptr();
+  }
+
+  JProgression res(0, 0);
+  if (lprog && rprog) {
+    if (larg.get_dims() != rarg.get_dims() || 
+	!ProgressionRule<Op>::with_progression(*lprog, *rprog, &res)) {
+      return JNoun::Ptr();
+    }
+  } else {
+    const JNoun& scalar(lprog ? rarg : larg);
+    if (!scalar.is_scalar()) return JNoun::Ptr();
+
+    JInt64 value(require_type<JInt64>(scalar).get_scalar_value());
+    if (!ProgressionRule<Op>::with_scalar(lprog ? *lprog : *rprog, value, !lprog, &res)) {
+      return JNoun::Ptr();
+    }
+  }
+
+  j_value_type common_type(*TypeConversions::get_instance()->find_best_type_conversion(
+			     larg.get_value_type(), rarg.get_value_type()));
+  return progression_result(lprog ? larg.get_dims() : rarg.get_dims(), res, common_type);
+}
+
 template <template <typename> class Op>
 struct ScalarDyad: public Dyad {
   ScalarDyad(): Dyad(0, 0) {}
@@ -143,7 +666,23 @@ struct ScalarDyad: public Dyad {
   }
 
   JNoun::Ptr operator()(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg) const {
-    return CallWithCommonType<scalar_dyadic_apply<Op>::template Impl, JNoun::Ptr>()(larg, rarg, m);
+    return apply(m, larg, rarg, 0, 0);
+  }
+
+  JNoun::Ptr apply_owned(JMachine::Ptr m, const JNoun::Ptr& larg, const JNoun::Ptr& rarg) const {
+    return apply(m, *larg, *rarg, is_owned(larg) ? larg.get() : 0, is_owned(rarg) ? rarg.get() : 0);
+  }
+
+  bool is_elementwise() const { return true; }
+
+private:
+  JNoun::Ptr apply(JMachine::Ptr m, const JNoun& larg, const JNoun& rarg,
+		   const JNoun* lreusable, const JNoun* rreusable) const {
+    JNoun::Ptr lazy(progression_dyad<Op>(larg, rarg));
+    if (lazy) return lazy;
+
+    return CallWithCommonType<scalar_dyadic_apply<Op>::template Impl, JNoun::Ptr>()(larg, rarg, m,
+										    lreusable, rreusable);
   }
 };
 
@@ -172,8 +711,19 @@ struct ScalarMonad: public Monad {
   }
 
   JNoun::Ptr operator()(JMachine::Ptr, const JNoun& arg) const {
+    return apply(arg, 0);
+  }
+
+  JNoun::Ptr apply_owned(JMachine::Ptr, const JNoun::Ptr& arg) const {
+    return apply(*arg, is_owned(arg) ? arg.get() : 0);
+  }
+
+  bool is_elementwise() const { return true; }
+
+private:
+  JNoun::Ptr apply(const JNoun& arg, const JNoun* reusable) const {
     JArrayCaller<scalar_monadic_apply<Op>::template Impl, JNoun::Ptr> caller;
-    return caller(arg);
+    return caller(arg, reusable);
   }
 };
   
@@ -194,18 +744,18 @@ public:
 
 
 class DimensionCounter { 
-  vector<int> reference;
-  vector<int> current_count;
-  vector<int> suffix_array;
+  vector<JSize> reference;
+  vector<JSize> current_count;
+  vector<JSize> suffix_array;
   bool turned_around;
 
   void increment(int pos); 
 
 public:
-  DimensionCounter(const vector<int>& ref);
+  DimensionCounter(const vector<JSize>& ref);
     
   DimensionCounter& operator++();
-  int operator*() const;
+  JSize operator*() const;
   bool at_end() const { 
     return turned_around; 
   }
@@ -228,19 +778,6 @@ public:
   VerbContainer(JMachine::Ptr jmachine, JVerb::Ptr verb): verb(verb), jmachine(jmachine) {}
 };
 
-template <typename Arg>
-struct BadScalarMonadOp: std::unary_function<Arg, Arg> { 
-  Arg operator()(Arg) {
-    throw JIllegalValueTypeException();
-  }
-};
-
-template <typename Arg>
-struct BadScalarDyadOp: std::binary_function<Arg, Arg, Arg> { 
-  Arg operator()(Arg, Arg) {
-    throw JIllegalValueTypeException();
-  }
-};  
 
 
 template <typename T>
@@ -2,6 +2,18 @@
 #include "ParserCombinators.hpp"
 #include "JEvaluator.hpp"
 #include "JExecutor.hpp"
+#include "JRagged.hpp"
+#include "JBufferPool.hpp"
+#include "JSerialize.hpp"
+#include "JMappedNoun.hpp"
+#include "JDelimited.hpp"
+#include "JFormatter.hpp"
+#include "JSimd.hpp"
+#include <cstdlib>
+#include <limits>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE J
@@ -28,7 +40,7 @@ BOOST_AUTO_TEST_CASE (test_dimensions_equal) {
   BOOST_CHECK_EQUAL(d, e);
 
   Dimensions f(2, 1, 2);
-  shared_ptr<vector<int> > v(new vector<int>(2));
+  shared_ptr<vector<JSize> > v(new vector<JSize>(2));
   v->operator[](0) = 1;
   v->operator[](1) = 2;
   Dimensions g(v, v->begin(), v->end());
@@ -45,6 +57,12 @@ BOOST_AUTO_TEST_CASE ( test_dimensions_addition ) {
   BOOST_CHECK_EQUAL(f + e, Dimensions(6, 1, 2, 3, 4, 5, 6));
 }
 
+BOOST_AUTO_TEST_CASE ( test_dimensions_64_bit ) {
+  Dimensions d(2, 50000, 50000);
+  BOOST_CHECK_EQUAL(d.number_of_elems(), JSize(2500000000L));
+  BOOST_CHECK_EQUAL((Dimensions(1, JSize(3000000000L)) + d).number_of_elems(), JSize(7500000000000000000L));
+}
+
 BOOST_AUTO_TEST_CASE ( test_dimensions_starfix) {
   Dimensions d;
   
@@ -87,7 +105,22 @@ BOOST_AUTO_TEST_CASE ( test_dimensions_number_index ) {
   BOOST_CHECK_EQUAL(e.suffix(-1).number_of_elems(), 120);
   BOOST_CHECK_EQUAL(e.prefix(-2).number_of_elems(), 12);
 }
-  
+
+BOOST_AUTO_TEST_CASE ( test_dimensions_high_rank ) {
+  Dimensions d(10, 1, 2, 3, 1, 2, 3, 1, 2, 3, 2);
+  Dimensions e(d);
+
+  BOOST_CHECK_EQUAL(e, d);
+  BOOST_CHECK_EQUAL(d.number_of_elems(), 432);
+  BOOST_CHECK_EQUAL(d.prefix(3), Dimensions(3, 1, 2, 3));
+  BOOST_CHECK_EQUAL(d.suffix(9), e.suffix(-1));
+  BOOST_CHECK_EQUAL(d.prefix(5) + d.suffix(5), d);
+
+  e = Dimensions(2, 4, 5);
+  BOOST_CHECK_EQUAL(e.number_of_elems(), 20);
+  BOOST_CHECK_EQUAL((d + e).number_of_elems(), 8640);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE ( vectorcounter_tests ) 
@@ -143,9 +176,9 @@ BOOST_AUTO_TEST_CASE ( jarray_deep_coordinate ) {
     
   JArray<JInt> arr(Dimensions(3, 3, 4, 5), v);
   
-  BOOST_CHECK_EQUAL(arr[1], *arr.coordinate(1, 1));
-  BOOST_CHECK_EQUAL(arr[2][3], *arr.coordinate(2, 2, 3));
-  BOOST_CHECK_EQUAL(arr[2][3][2], *arr.coordinate(3, 2, 3, 2));
+  BOOST_CHECK_EQUAL(arr[1], *arr.coordinate(1));
+  BOOST_CHECK_EQUAL(arr[2][3], *arr.coordinate(2, 3));
+  BOOST_CHECK_EQUAL(arr[2][3][2], *arr.coordinate(2, 3, 2));
 }
 
 BOOST_AUTO_TEST_CASE ( jarray_extend ) {
@@ -233,6 +266,499 @@ BOOST_AUTO_TEST_CASE ( jarray_scalarop_iterator ) {
   BOOST_CHECK_EQUAL(*osi, 3);
 }
 
+BOOST_AUTO_TEST_CASE ( jarray_shared_buffer ) {
+  JArray<JInt> arr(Dimensions(3, 3, 4, 5),
+		   0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,
+		   20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,
+		   40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59);
+  BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(arr.begin()) % buffer_alignment, 0u);
+
+  JArray<JInt> row(arr[1]);
+  BOOST_CHECK(row.get_content() == arr.get_content());
+  BOOST_CHECK_EQUAL(row.get_offset(), 20u);
+
+  JNoun::Ptr cell(arr.coordinate(2, 3));
+  BOOST_CHECK(static_cast<JArray<JInt>&>(*cell).get_content() == arr.get_content());
+  BOOST_CHECK_EQUAL(static_cast<JArray<JInt>&>(*cell).get_offset(), 55u);
+  BOOST_CHECK_EQUAL(*cell, JArray<JInt>(Dimensions(1, 5), 55, 56, 57, 58, 59));
+
+  JBuffer<JFloat>::Ptr big(JBuffer<JFloat>::Instantiate(hugepage_size));
+  BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(big->begin()) % hugepage_size, 0u);
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_inline_scalars ) {
+  JArray<JInt> scalar(7);
+  BOOST_CHECK_EQUAL(scalar, JArray<JInt>(Dimensions(0), 7));
+  BOOST_CHECK_EQUAL(scalar.get_scalar_value(), 7);
+  BOOST_CHECK_EQUAL(JArray<JBool>(true).get_scalar_value(), true);
+  BOOST_CHECK_EQUAL(scalar.get_content()->get_size(), 1u);
+  BOOST_CHECK_EQUAL(*scalar.get_content()->begin(), 7);
+
+  BOOST_CHECK(scalar_noun<JInt>(3) == scalar_noun<JInt>(3));
+  BOOST_CHECK(scalar_noun<JInt>(100000) != scalar_noun<JInt>(100000));
+  BOOST_CHECK(scalar_noun<JFloat>(1.0) == scalar_noun<JFloat>(1.0));
+  BOOST_CHECK(scalar_noun<JFloat>(-0.0) != scalar_noun<JFloat>(0.0));
+
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  BOOST_CHECK_EQUAL(*executor("1 + 2"), JArray<JInt>(Dimensions(0), 3));
+  BOOST_CHECK(executor("1 + 2") == executor("3"));
+  BOOST_CHECK_EQUAL(*executor("+/ 1 2 3"), JArray<JInt>(Dimensions(0), 6));
+  BOOST_CHECK_EQUAL(*executor("1 2 3 + 1"), JArray<JInt>(Dimensions(1, 3), 2, 3, 4));
+  BOOST_CHECK_EQUAL(*executor("- 5"), JArray<JInt>(Dimensions(0), -5));
+}
+
+static void store_active_arena(JArena** seen) {
+  *seen = JArena::get_active();
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_sentence_arena ) {
+  JBuffer<JInt>::Ptr escaping;
+  {
+    JArena arena;
+    BOOST_CHECK_EQUAL(JArena::get_active(), &arena);
+
+    JBuffer<JInt>::Ptr temporary(JBuffer<JInt>::InstantiateFilled(8, 3));
+    escaping = JBuffer<JInt>::InstantiateFilled(16, 7);
+    BOOST_CHECK(temporary->is_arena_allocated());
+    BOOST_CHECK(escaping->is_arena_allocated());
+    BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(escaping->begin()) % buffer_alignment, 0u);
+
+    BOOST_CHECK(!JBuffer<JInt>::Instantiate(JArena::max_allocation)->is_arena_allocated());
+    BOOST_CHECK(!JBuffer<JBox>::Instantiate(1)->is_arena_allocated());
+  }
+  BOOST_CHECK(!JArena::get_active());
+  BOOST_CHECK(!escaping->is_arena_allocated());
+
+  {
+    JArena arena;
+    const JInt* first(JBuffer<JInt>::Instantiate(100)->begin());
+    BOOST_CHECK_EQUAL(JBuffer<JInt>::Instantiate(100)->begin(), first);
+
+    vector<JBuffer<JInt>::Ptr> kept;
+    std::size_t bytes(JArena::max_allocation);
+    for (std::size_t used = 0; used <= JArena::max_sentence_bytes; used += bytes) {
+      kept.push_back(JBuffer<JInt>::Instantiate(bytes / sizeof(JInt)));
+    }
+    BOOST_CHECK(kept.front()->is_arena_allocated());
+    BOOST_CHECK(!kept.back()->is_arena_allocated());
+  }
+
+  {
+    JArena arena;
+    JArena* seen(&arena);
+    boost::thread other(boost::bind(&store_active_arena, &seen));
+    other.join();
+    BOOST_CHECK(!seen);
+  }
+  BOOST_CHECK_EQUAL(std::count(escaping->begin(), escaping->end(), 7), 16);
+
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  JWord::Ptr res(executor("1 2 3 + 4 5 6"));
+  BOOST_CHECK(!static_cast<JArray<JInt>&>(*res).get_content()->is_arena_allocated());
+  BOOST_CHECK_EQUAL(*res, JArray<JInt>(Dimensions(1, 3), 5, 7, 9));
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_compact_header ) {
+  BOOST_CHECK_LE(sizeof(Dimensions), 4 * sizeof(JSize));
+  BOOST_CHECK_LE(sizeof(JArray<JInt>), 96u);
+
+  Dimensions cube(3, 2, 3, 4);
+  Dimensions square(2, 5, 5);
+  square = cube;
+  BOOST_CHECK_EQUAL(square, cube);
+  BOOST_CHECK_EQUAL(square.number_of_elems(), 24);
+  cube = Dimensions(1, 7);
+  BOOST_CHECK_EQUAL(cube[0], 7);
+  BOOST_CHECK_EQUAL(cube.number_of_elems(), 7);
+
+  JArray<JInt> lazy(Dimensions(2, 2, 3), JProgression(0, 1));
+  BOOST_CHECK(lazy.get_progression());
+  BOOST_CHECK(!lazy.has_unique_content());
+  BOOST_CHECK_EQUAL(lazy[1], JArray<JInt>(Dimensions(1, 3), 3, 4, 5));
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_intrusive_counts ) {
+  JNoun::Ptr noun(new JArray<JInt>(Dimensions(1, 3), 1, 2, 3));
+  BOOST_CHECK(noun->is_unique());
+
+  JNoun::Ptr copy(noun);
+  BOOST_CHECK(!noun->is_unique());
+  copy->publish();
+  BOOST_CHECK(noun->is_published());
+  copy.reset();
+  BOOST_CHECK(noun->is_unique());
+
+  BOOST_CHECK(scalar_noun<JInt>(7)->is_published());
+  BOOST_CHECK(scalar_noun<JBool>(true)->is_published());
+  BOOST_CHECK(scalar_noun<JFloat>(0.0)->is_published());
+  BOOST_CHECK(scalar_noun<JInt>(7) == scalar_noun<JInt>(7));
+
+  JArray<JInt> value(static_cast<const JArray<JInt>&>(*noun));
+  BOOST_CHECK(!value.is_published());
+  BOOST_CHECK(!value.get_content()->is_unique());
+  BOOST_CHECK_EQUAL(*value.clone(), *noun);
+}
+
+static void share_internals(const JArray<JInt>* dense, const JArray<JInt>* lazy) {
+  for (int i = 0; i < 20000; ++i) {
+    JArray<JInt> dense_copy(*dense);
+    JArray<JInt> lazy_copy(*lazy);
+    JArray<JInt>::container_ptr buffer(dense->get_content());
+    JArray<JInt>::container_ptr values(lazy->get_content());
+    JArray<JInt>::container_ptr cached(static_cast<const JArray<JInt>&>(*scalar_noun<JInt>(1)).get_content());
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_published_internals ) {
+  JNoun::Ptr noun(new JArray<JInt>(Dimensions(1, 3), 1, 2, 3));
+  noun->publish();
+  const JArray<JInt>& dense(static_cast<const JArray<JInt>&>(*noun));
+  BOOST_CHECK(dense.get_content()->is_published());
+
+  JArray<JInt>::container_ptr source(JBuffer<JInt>::Instantiate(6));
+  std::copy(dense.begin(), dense.end(), source->begin());
+  std::copy(dense.begin(), dense.end(), source->begin() + 3);
+  vector<JSize> strides(2);
+  strides[0] = 1;
+  strides[1] = 3;
+  JArray<JInt> transposed(Dimensions(2, 3, 2), source, 0, strides);
+  source.reset();
+  transposed.publish();
+  BOOST_CHECK(transposed.get_content()->is_published());
+
+  JArray<JInt> lazy(Dimensions(1, 1000), JProgression(0, 1));
+  lazy.publish();
+  BOOST_CHECK(lazy.get_content()->is_published());
+
+  const JArray<JInt>& one(static_cast<const JArray<JInt>&>(*scalar_noun<JInt>(1)));
+  BOOST_CHECK(one.get_content() != one.get_content());
+  BOOST_CHECK_EQUAL(one.get_content()->begin()[0], 1);
+  BOOST_CHECK_EQUAL(*one.view(Dimensions(1, 1), 0), JArray<JInt>(Dimensions(1, 1), 1));
+  vector<boost::thread*> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(new boost::thread(boost::bind(&share_internals, &dense, &lazy)));
+  }
+  for (std::size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->join();
+    delete threads[i];
+  }
+  BOOST_CHECK(dense.has_unique_content());
+  BOOST_CHECK(noun->is_unique());
+  BOOST_CHECK(lazy.get_progression());
+  BOOST_CHECK_EQUAL(lazy[999], JArray<JInt>(999));
+}
+
+static const std::size_t pooled_bytes = 5 * 1024 * 1024;
+
+static void cache_pool_buffer(boost::barrier* allocated) {
+  void* data(JBufferPool::allocate(pooled_bytes));
+  allocated->wait();
+  JBufferPool::release(data, pooled_bytes);
+}
+
+static void idle_with_large_buffer(boost::barrier* cached, std::size_t* retained) {
+  JBufferPool::release(JBufferPool::allocate(pooled_bytes), pooled_bytes);
+  retained[0] = JBufferPool::get_retained_bytes();
+  cached->wait();
+  cached->wait();
+  retained[1] = JBufferPool::get_retained_bytes();
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_buffer_pool ) {
+  JBufferPool::release_thread_cache();
+  void* small(JBufferPool::allocate(1000));
+  JBufferPool::release(small, 1000);
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), 1024u);
+  BOOST_CHECK_EQUAL(JBufferPool::allocate(980), small);
+  JBufferPool::release(small, 980);
+
+  void* large(JBufferPool::allocate(JBufferPool::large_buffer_bytes));
+  JBufferPool::release(large, JBufferPool::large_buffer_bytes);
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), 1024u + JBufferPool::large_buffer_bytes);
+  JBufferPool::trim_idle(std::time(0));
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), 1024u + JBufferPool::large_buffer_bytes);
+  JBufferPool::trim_idle(std::time(0) + JBufferPool::large_idle_seconds + 1);
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), 1024u);
+
+  JBufferPool::set_retention_limit(0);
+  JBuffer<JInt>::Instantiate(100);
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), 1024u);
+  JBufferPool::set_retention_limit(JBufferPool::default_retention_limit);
+  JBufferPool::release_thread_cache();
+
+  std::size_t shared(JBufferPool::get_shared_bytes());
+  boost::barrier allocated(4);
+  vector<boost::thread*> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(new boost::thread(boost::bind(&cache_pool_buffer, &allocated)));
+  }
+  for (std::size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->join();
+    delete threads[i];
+  }
+  BOOST_CHECK_EQUAL(JBufferPool::get_shared_bytes(), shared + 4 * pooled_bytes);
+  void* reused(JBufferPool::allocate(pooled_bytes));
+  BOOST_CHECK_EQUAL(JBufferPool::get_shared_bytes(), shared + 3 * pooled_bytes);
+  JBufferPool::release(reused, pooled_bytes);
+  BOOST_CHECK_EQUAL(JBufferPool::get_retained_bytes(), pooled_bytes);
+  JBufferPool::release_thread_cache();
+
+  boost::barrier cached(2);
+  std::size_t retained[2];
+  boost::thread idle(boost::bind(&idle_with_large_buffer, &cached, retained));
+  cached.wait();
+  JBufferPool::trim_idle(std::time(0) + JBufferPool::large_idle_seconds + 1);
+  cached.wait();
+  idle.join();
+  BOOST_CHECK_EQUAL(retained[0], pooled_bytes);
+  BOOST_CHECK_EQUAL(retained[1], 0u);
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_external_payload ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  shared_ptr<vector<JInt> > host(new vector<JInt>(6));
+  for (int i = 0; i < 6; ++i) (*host)[i] = i + 1;
+
+  {
+    JNoun::Ptr noun(external_array<JInt>(Dimensions(2, 2, 3), &(*host)[0], host));
+    const JArray<JInt>& arr(static_cast<const JArray<JInt>&>(*noun));
+    BOOST_CHECK(!host.unique());
+    BOOST_CHECK(arr.get_content()->is_external());
+    BOOST_CHECK_EQUAL(arr.begin(), &(*host)[0]);
+    BOOST_CHECK(!arr.has_unique_content());
+
+    JNoun::Ptr sum(PlusVerb().apply_owned(m, noun, JNoun::Ptr(new JArray<JInt>(Dimensions(0), 10))));
+    BOOST_CHECK_EQUAL(*sum, JArray<JInt>(Dimensions(2, 2, 3), 11, 12, 13, 14, 15, 16));
+    BOOST_CHECK_EQUAL((*host)[0], 1);
+    BOOST_CHECK_EQUAL(*noun, JArray<JInt>(Dimensions(2, 2, 3), 1, 2, 3, 4, 5, 6));
+  }
+  BOOST_CHECK(host.unique());
+
+  BOOST_CHECK(!JArena::holds(&(*host)[0]));
+  {
+    JArena arena;
+    JBuffer<JInt>::Ptr scratch(JBuffer<JInt>::Instantiate(6));
+    BOOST_CHECK(scratch->is_arena_allocated());
+    BOOST_CHECK(JArena::holds(scratch->begin()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_serialization ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  JArray<JBool> bits(Dimensions(1, 100), JBuffer<JBool>::InstantiateFilled(100, false));
+  for (int i = 0; i < 100; i += 3) bits.begin()[i] = true;
+
+  vector<JNoun::Ptr> nouns;
+  nouns.push_back(JNoun::Ptr(new JArray<JInt>(Dimensions(2, 2, 3), 1, -2, 3, 4, 5, 6)));
+  nouns.push_back(JNoun::Ptr(new JArray<JInt8>(Dimensions(1, 3), 1, 2, -3)));
+  nouns.push_back(JNoun::Ptr(new JArray<JInt16>(Dimensions(0), 300)));
+  nouns.push_back(JNoun::Ptr(new JArray<JInt64>(Dimensions(3, 1, 2, 1), 1L << 40, -7L)));
+  nouns.push_back(JNoun::Ptr(new JArray<JFloat>(Dimensions(1, 2), 2.5, -0.125)));
+  nouns.push_back(JNoun::Ptr(filled_array<JComplex>(Dimensions(1, 3), JComplex(1.5, -2))));
+  nouns.push_back(JNoun::Ptr(new JArray<JChar>(Dimensions(1, 5), 'h', 'e', 'l', 'l', 'o')));
+  nouns.push_back(bits.view(Dimensions(1, 90), 3));
+  nouns.push_back(JNoun::Ptr(new JArray<JInt>(Dimensions(2, 0, 4))));
+  nouns.push_back(boost::static_pointer_cast<JNoun>(executor("1 2 ; (2 2 $ 1 2 3 4) ; < < 6")));
+
+  for (vector<JNoun::Ptr>::iterator i = nouns.begin(); i != nouns.end(); ++i) {
+    std::stringstream stream;
+    encode_noun(stream, **i);
+    string bytes(stream.str());
+    BOOST_CHECK_EQUAL(bytes.size(), encoded_size(**i));
+    BOOST_CHECK_EQUAL(bytes.size() % 8, 0);
+    BOOST_CHECK_EQUAL(bytes.substr(0, 3), "JNB");
+    BOOST_CHECK_EQUAL(*decode_noun(stream), **i);
+  }
+
+  std::stringstream stream;
+  encode_noun(stream, *nouns[0]);
+  encode_noun(stream, *nouns[6]);
+  BOOST_CHECK_EQUAL(*decode_noun(stream), *nouns[0]);
+  BOOST_CHECK_EQUAL(*decode_noun(stream), *nouns[6]);
+  BOOST_CHECK_THROW(decode_noun(stream), JSerializationException);
+
+  shared_ptr<vector<JInt64> > aligned(new vector<JInt64>(encoded_size(*nouns[0]) / sizeof(JInt64)));
+  std::stringstream out;
+  encode_noun(out, *nouns[0]);
+  out.read(reinterpret_cast<char*>(&(*aligned)[0]), aligned->size() * sizeof(JInt64));
+  const char* data(reinterpret_cast<const char*>(&(*aligned)[0]));
+  {
+    JNoun::Ptr wrapped(decode_noun(data, aligned->size() * sizeof(JInt64), aligned));
+    const JArray<JInt>& arr(static_cast<const JArray<JInt>&>(*wrapped));
+    BOOST_CHECK(arr.get_content()->is_external());
+    BOOST_CHECK_EQUAL(reinterpret_cast<const char*>(arr.begin()), data + 32);
+    BOOST_CHECK_EQUAL(*wrapped, *nouns[0]);
+    BOOST_CHECK_THROW(decode_noun(data, 40, aligned), JSerializationException);
+  }
+  BOOST_CHECK(aligned.unique());
+  BOOST_CHECK_THROW(decode_noun(data + 8, 32, shared_ptr<void>()), JSerializationException);
+
+  const char* claimed[] = { "1 2 3", "0 1 0", "1 ; 2" };
+  for (int i = 0; i < 3; ++i) {
+    std::stringstream huge;
+    encode_noun(huge, *boost::static_pointer_cast<JNoun>(executor(claimed[i])));
+    string forged(huge.str());
+    forged.replace(16, 8, string("\0\0\0\0\0\1\0\0", 8));
+    BOOST_CHECK_THROW(decode_noun(forged.data(), forged.size(), shared_ptr<void>()), JSerializationException);
+    std::stringstream forged_stream(forged);
+    BOOST_CHECK_THROW(decode_noun(forged_stream), JSerializationException);
+  }
+  JNoun::Ptr long_list(boost::static_pointer_cast<JNoun>(executor("i. 1000000")));
+  std::stringstream long_stream;
+  encode_noun(long_stream, *long_list);
+  BOOST_CHECK_EQUAL(*decode_noun(long_stream), *long_list);
+
+  BOOST_CHECK_EQUAL(*executor("3!:2 (3!:1 (1 2 ; 3 4 5 ; < 6))"), *executor("1 2 ; 3 4 5 ; < 6"));
+  JNoun::Ptr list(boost::static_pointer_cast<JNoun>(executor("1 2 3")));
+  BOOST_CHECK_EQUAL(*executor("$ (3!:1) 1 2 3"), JArray<JInt>(Dimensions(1, 1), static_cast<JInt>(encoded_size(*list))));
+  executor("decoded =: (3!:2) (3!:1) 11 22 33 44");
+  executor("scratch =: 1000 $ 7 8 9");
+  executor("scratch =: (scratch + 1) * scratch - 1");
+  BOOST_CHECK_EQUAL(*executor("decoded"), JArray<JInt>(Dimensions(1, 4), 11, 22, 33, 44));
+  JNoun::Ptr big(boost::static_pointer_cast<JNoun>(executor("(3!:2) (3!:1) i. 10000")));
+  BOOST_CHECK(static_cast<const JArray<JInt>&>(*big).get_content()->is_external());
+  BOOST_CHECK_THROW(executor("(3!:2) 1 2 3"), JIllegalValueTypeException);
+  BOOST_CHECK_THROW(executor("(4!:1) 1 2 3"), JUnimplementedOperationException);
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_mapped_noun ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  char path[] = "/tmp/jmappedXXXXXX";
+  close(mkstemp(path));
+  JMappedNoun::create(path, JArray<JInt>(Dimensions(1, 4), 1, 2, 3, 4));
+
+  JMappedNoun::Ptr shared(JMappedNoun::Instantiate(path));
+  const JArray<JInt>& column(static_cast<const JArray<JInt>&>(*shared->get_noun()));
+  BOOST_CHECK(column.get_content()->is_external());
+  BOOST_CHECK(!column.has_unique_content());
+  JVerb::Ptr sum(boost::static_pointer_cast<JVerb>(executor("+/")));
+  BOOST_CHECK_EQUAL(*(*sum)(m, column), JArray<JInt>(Dimensions(0), 10));
+
+  JMappedNoun::Ptr private_copy(JMappedNoun::Instantiate(path, map_mode_copy_on_write));
+  const JArray<JInt>& copy(static_cast<const JArray<JInt>&>(*private_copy->get_noun()));
+  BOOST_CHECK(copy.get_content()->is_writable());
+  copy.begin()[0] = 100;
+  BOOST_CHECK_EQUAL(column.begin()[0], 1);
+
+  JMappedNoun::Ptr growing(JMappedNoun::Instantiate(path, map_mode_append));
+  growing->append(JArray<JInt>(Dimensions(0), 5));
+  growing->append(JArray<JInt>(Dimensions(1, 2), 6, 7));
+  JArray<JInt> grown(Dimensions(1, 7), 1, 2, 3, 4, 5, 6, 7);
+  BOOST_CHECK_EQUAL(*growing->get_noun(), grown);
+  BOOST_CHECK_EQUAL(*shared->get_noun(), JArray<JInt>(Dimensions(1, 4), 1, 2, 3, 4));
+  BOOST_CHECK_EQUAL(*JMappedNoun::Instantiate(path)->get_noun(), grown);
+
+  BOOST_CHECK_THROW(shared->append(JArray<JInt>(Dimensions(0), 8)), JFileException);
+  BOOST_CHECK_THROW(growing->append(JArray<JFloat>(Dimensions(0), 1.5)), JIllegalValueTypeException);
+  BOOST_CHECK_THROW(growing->append(JArray<JInt>(Dimensions(2, 1, 1), 8)), JIllegalDimensionsException);
+  unlink(path);
+  BOOST_CHECK_THROW(JMappedNoun::Instantiate(path), JFileException);
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_delimited_loader ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  string text("id,price,volume\r\n1,2.5,10000000000\n-2,_3,7\n\n3,1e2,_8\n4,0.125,9\n");
+
+  vector<JNoun::Ptr> columns(parse_delimited_columns(text.data(), text.data() + text.size(),
+						     JDelimitedFormat(',', true, 3)));
+  BOOST_REQUIRE_EQUAL(columns.size(), 3);
+  BOOST_CHECK_EQUAL(*columns[0], JArray<JInt>(Dimensions(1, 4), 1, -2, 3, 4));
+  BOOST_CHECK_EQUAL(*columns[1], JArray<JFloat>(Dimensions(1, 4), 2.5, -3.0, 100.0, 0.125));
+  BOOST_CHECK_EQUAL(*columns[2], JArray<JInt64>(Dimensions(1, 4), 10000000000L, 7L, -8L, 9L));
+
+  JNoun::Ptr table(parse_delimited_table(text.data(), text.data() + text.size(), 
+					 JDelimitedFormat(',', true)));
+  BOOST_CHECK_EQUAL(*table, JArray<JFloat>(Dimensions(2, 4, 3), 1.0, 2.5, 1e10, -2.0, -3.0, 7.0, 
+					    3.0, 100.0, -8.0, 4.0, 0.125, 9.0));
+
+  string ragged("1 2\n3\n");
+  BOOST_CHECK_THROW(parse_delimited_table(ragged.data(), ragged.data() + ragged.size(), 
+					  JDelimitedFormat(' ')), JIllegalDimensionsException);
+  string malformed("1;2\n3;x\n");
+  BOOST_CHECK_THROW(parse_delimited_table(malformed.data(), malformed.data() + malformed.size(), 
+					  JDelimitedFormat(';', false, 2)), JIllegalSyntaxException);
+
+  char path[] = "/tmp/jdelimitedXXXXXX";
+  int fd(mkstemp(path));
+  string file("1\t2\n3\t4\n5\t6");
+  BOOST_REQUIRE_EQUAL(write(fd, file.data(), file.size()), static_cast<ssize_t>(file.size()));
+  close(fd);
+
+  JArray<JChar> name(Dimensions(1, std::strlen(path)), JBuffer<JChar>::InstantiateCopy(path, path + std::strlen(path)));
+  JArray<JChar> tab(static_cast<JChar>('\t'));
+  BOOST_CHECK_EQUAL(*LoadDelimitedVerb()(m, tab, name), JArray<JInt>(Dimensions(2, 3, 2), 1, 2, 3, 4, 5, 6));
+  BOOST_CHECK_EQUAL(load_delimited_columns(path, JDelimitedFormat('\t')).size(), 2);
+  BOOST_CHECK_THROW(LoadDelimitedVerb()(m, JArray<JInt>(9), name), JIllegalValueTypeException);
+  unlink(path);
+
+  char comma_path[] = "/tmp/jdelimitedXXXXXX";
+  fd = mkstemp(comma_path);
+  string comma_file("1,2\n3,4\n5,6\n");
+  BOOST_REQUIRE_EQUAL(write(fd, comma_file.data(), comma_file.size()), static_cast<ssize_t>(comma_file.size()));
+  close(fd);
+  JArray<JChar> comma_name(Dimensions(1, std::strlen(comma_path)), 
+			   JBuffer<JChar>::InstantiateCopy(comma_path, comma_path + std::strlen(comma_path)));
+  JExecutor executor(m);
+  JVerb::Ptr loader(boost::static_pointer_cast<JVerb>(executor("1!:50")));
+  BOOST_CHECK_EQUAL(*(*loader)(m, comma_name), JArray<JInt>(Dimensions(2, 3, 2), 1, 2, 3, 4, 5, 6));
+  BOOST_CHECK_EQUAL(*(*loader)(m, JArray<JChar>(static_cast<JChar>(',')), comma_name), 
+		    JArray<JInt>(Dimensions(2, 3, 2), 1, 2, 3, 4, 5, 6));
+  unlink(comma_path);
+  BOOST_CHECK_THROW(LoadDelimitedVerb()(m, name), JFileException);
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_formatter ) {
+  BOOST_CHECK_EQUAL(JArray<JInt>(Dimensions(1, 3), 5, -120, 7).content_string(), "   5 -120    7 ");
+  BOOST_CHECK_EQUAL(JArray<JInt>(Dimensions(0), -3).content_string(), "-3");
+  BOOST_CHECK_EQUAL(JArray<JFloat>(Dimensions(1, 3), 0.1, 2.0, 1e300).content_string(), 
+		    "   0.1      2 1e+300 ");
+  BOOST_CHECK_EQUAL(JArray<JFloat>(Dimensions(0), 0.1 + 0.2).content_string(), "0.30000000000000004");
+  BOOST_CHECK_EQUAL(JArray<JFloat>(Dimensions(0), -0.0625).content_string(), "-0.0625");
+  BOOST_CHECK_EQUAL(JArray<JBool>(Dimensions(1, 3), 1, 0, 1).content_string(), "1 0 1 ");
+  BOOST_CHECK_EQUAL(JArray<JChar>(Dimensions(1, 2), 'o', 'k').content_string(), "o k ");
+  BOOST_CHECK_EQUAL(filled_array<JComplex>(Dimensions(1, 1), JComplex(1.5, -2))->content_string(), "(1.5,-2) ");
+  BOOST_CHECK_EQUAL(JArray<JInt8>(Dimensions(3, 2, 2, 2), 1, 2, 3, 4, 5, 6, 7, 8).content_string(),
+		    "1 2 \n3 4 \n\n5 6 \n7 8 \n\n");
+
+  JNoun::Ptr big(progression_array(Dimensions(2, 1000, 1000), JProgression(0, 1), j_value_type_int));
+  std::stringstream shown;
+  format_noun(shown, *big, JFormatOptions(2, 3));
+  BOOST_CHECK_EQUAL(shown.str(), "   0    1    2 ... \n1000 1001 1002 ... \n...\n");
+
+  std::stringstream full;
+  format_noun(full, *big);
+  BOOST_CHECK_EQUAL(full.str(), static_cast<const JArray<JInt>&>(*big).content_string());
+  BOOST_CHECK_EQUAL(full.str().size(), 1000 * (1000 * 7 + 1));
+}
+
+BOOST_AUTO_TEST_CASE ( jarray_flat_boxes ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  JWord::Ptr links(executor("1 2 ; 3 4 5 ; 6"));
+  const JArray<JBox>& boxes(static_cast<const JArray<JBox>&>(*links));
+  BOOST_CHECK(boxes.get_ragged());
+  BOOST_CHECK_EQUAL(boxes.get_dims(), Dimensions(1, 3));
+  BOOST_CHECK_EQUAL(*boxes[1].get_scalar_value().get_contents(), JArray<JInt>(Dimensions(1, 3), 3, 4, 5));
+  BOOST_CHECK(*links == *executor("(<1 2) , (<3 4 5) , <6"));
+
+  JNoun::Ptr razed(flat_raze(boxes));
+  BOOST_CHECK_EQUAL(*razed, JArray<JInt>(Dimensions(1, 6), 1, 2, 3, 4, 5, 6));
+  BOOST_CHECK(static_cast<const JArray<JInt>&>(*razed).get_content() == 
+	      static_cast<const JArray<JInt>&>(*boxes.get_ragged()->payload).get_content());
+
+  BOOST_CHECK_EQUAL(*executor("; 1 2 ; 3 4 5 ; 6"), JArray<JInt>(Dimensions(1, 6), 1, 2, 3, 4, 5, 6));
+  BOOST_CHECK_EQUAL(*executor("; (2 2 $ 1 2 3 4) ; 1 2 $ 5 6"), 
+		    JArray<JInt>(Dimensions(2, 3, 2), 1, 2, 3, 4, 5, 6));
+  BOOST_CHECK_EQUAL(*executor("> 1 2 ; 3 4"), JArray<JInt>(Dimensions(2, 2, 2), 1, 2, 3, 4));
+  BOOST_CHECK_EQUAL(*executor("> 1 2 ; 3"), JArray<JInt>(Dimensions(2, 2, 2), 1, 2, 3, 0));
+  BOOST_CHECK_EQUAL(*executor("; 1 2 ; 3 ; 4.5"), JArray<JFloat>(Dimensions(1, 4), 1.0, 2.0, 3.0, 4.5));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE ( verbs )
@@ -307,6 +833,411 @@ BOOST_AUTO_TEST_CASE ( test_minus_op ) {
   		    JArray<JInt>(Dimensions(2,2,2), -1, -2, -3,-4));
 }
 
+BOOST_AUTO_TEST_CASE ( test_scalar_verb_in_place ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  PlusVerb plus;
+  MinusVerb minus;
+
+  JNoun::Ptr larg(new JArray<JInt>(Dimensions(1, 4), 1, 2, 3, 4));
+  JNoun::Ptr rarg(new JArray<JInt>(Dimensions(0), 10));
+  JArray<JInt>::iter data(static_cast<JArray<JInt>&>(*larg).begin());
+  JNoun::Ptr res(plus.apply_owned(m, larg, rarg));
+  BOOST_CHECK_EQUAL(*res, JArray<JInt>(Dimensions(1, 4), 11, 12, 13, 14));
+  BOOST_CHECK(static_cast<JArray<JInt>&>(*res).begin() == data);
+
+  larg.reset();
+  res = minus.apply_owned(m, res);
+  BOOST_CHECK_EQUAL(*res, JArray<JInt>(Dimensions(1, 4), -11, -12, -13, -14));
+  BOOST_CHECK(static_cast<JArray<JInt>&>(*res).begin() == data);
+
+  JNoun::Ptr shared(res);
+  JNoun::Ptr res2(minus.apply_owned(m, res));
+  BOOST_CHECK(static_cast<JArray<JInt>&>(*res2).begin() != data);
+  BOOST_CHECK_EQUAL(*shared, JArray<JInt>(Dimensions(1, 4), -11, -12, -13, -14));
+
+  JExecutor executor(m);
+  executor("a =: i. 5");
+  BOOST_CHECK_EQUAL(*executor("1 + 2 * a"), *executor("1 3 5 7 9"));
+  BOOST_CHECK_EQUAL(*executor("a"), *executor("0 1 2 3 4"));
+  BOOST_CHECK_EQUAL(*executor("(+ + +) a"), *executor("0 2 4 6 8"));
+  BOOST_CHECK_EQUAL(*executor("a"), *executor("0 1 2 3 4"));
+}
+
+BOOST_AUTO_TEST_CASE ( test_bool_type ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  shared_ptr<vector<JBool> > v(new vector<JBool>(150));
+  for (int i = 0; i < 150; ++i) (*v)[i] = i % 3 == 0;
+  JArray<JBool> arr(Dimensions(1, 150), v);
+  BOOST_CHECK_EQUAL(arr.get_value_type(), j_value_type_bool);
+  BOOST_CHECK_EQUAL(count_bits(arr.begin(), arr.end()), 50u);
+  BOOST_CHECK_EQUAL(count_bits(arr.begin() + 1, arr.end() - 1), 49u);
+
+  PlusVerb plus;
+  BOOST_CHECK_EQUAL(*plus.reduce(m, arr), JArray<JInt>(Dimensions(0), 50));
+  BOOST_CHECK_EQUAL(*plus.reduce(m, *arr.subarray(65, 150)), JArray<JInt>(Dimensions(0), 28));
+  BOOST_CHECK_EQUAL(*plus(m, arr[0], arr[0]), JArray<JInt>(Dimensions(0), 2));
+
+  LcmAndVerb and_verb;
+  NotVerb not_verb;
+  JNoun::Ptr tail(arr.subarray(1, 150));
+  JNoun::Ptr res(and_verb(m, *not_verb(m, *tail), *tail));
+  BOOST_CHECK_EQUAL(res->get_value_type(), j_value_type_bool);
+  BOOST_CHECK_EQUAL(*plus.reduce(m, *res), JArray<JInt>(Dimensions(0), 0));
+  BOOST_CHECK_EQUAL(*plus.reduce(m, *and_verb(m, arr, arr)), JArray<JInt>(Dimensions(0), 50));
+
+  JExecutor executor(m);
+  BOOST_CHECK_EQUAL(executor("(i. 10) < 5")->to_string(), JArray<JBool>(Dimensions(1, 10), 1,1,1,1,1,0,0,0,0,0).to_string());
+  BOOST_CHECK_EQUAL(*executor("+/ (i. 200) >: 70"), JArray<JInt>(Dimensions(0), 130));
+  BOOST_CHECK_EQUAL(*executor("+/ ((i. 100) < 70) +. (i. 100) >: 90"), JArray<JInt>(Dimensions(0), 80));
+  BOOST_CHECK_EQUAL(*executor("1 + (i. 4) < 2"), JArray<JInt>(Dimensions(1, 4), 2, 2, 1, 1));
+  BOOST_CHECK_EQUAL(*executor("12 +. 18"), JArray<JInt>(Dimensions(0), 6));
+  BOOST_CHECK_EQUAL(*executor("4 *. 6"), JArray<JInt>(Dimensions(0), 12));
+}
+
+BOOST_AUTO_TEST_CASE ( test_gcd_lcm_not ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(*executor("_12 +. 18 0"), JArray<JInt>(Dimensions(1, 2), 6, 12));
+  BOOST_CHECK_EQUAL(*executor("2.5 +. 1"), JArray<JFloat>(Dimensions(0), 0.5));
+  BOOST_CHECK_EQUAL(*executor("6j2 +. 4j2"), *filled_array<JComplex>(Dimensions(0), JComplex(2, 0)));
+  BOOST_CHECK_EQUAL(*executor("_4 *. 6 0"), JArray<JInt>(Dimensions(1, 2), -12, 0));
+  BOOST_CHECK_EQUAL(*executor("2.5 *. 1.5"), JArray<JFloat>(Dimensions(0), 7.5));
+  BOOST_CHECK_EQUAL(executor("((i. 4) < 2) +. (i. 4) > 2")->to_string(), 
+		    JArray<JBool>(Dimensions(1, 4), 1, 1, 0, 1).to_string());
+  BOOST_CHECK_EQUAL(executor("((i. 4) < 2) *. (i. 4) > 0")->to_string(), 
+		    JArray<JBool>(Dimensions(1, 4), 0, 1, 0, 0).to_string());
+
+  BOOST_CHECK_EQUAL(executor("-. (i. 3) < 1")->to_string(), JArray<JBool>(Dimensions(1, 3), 0, 1, 1).to_string());
+  BOOST_CHECK_EQUAL(*executor("-. 3 _2"), JArray<JInt>(Dimensions(1, 2), -2, 3));
+  BOOST_CHECK_EQUAL(*executor("-. 0.25"), JArray<JFloat>(Dimensions(0), 0.75));
+
+  BOOST_CHECK_EQUAL(*executor("+. 3 _4"), JArray<JInt>(Dimensions(2, 2, 2), 3, 0, -4, 0));
+  BOOST_CHECK_EQUAL(*executor("+. 3j4"), JArray<JFloat>(Dimensions(1, 2), 3.0, 4.0));
+  BOOST_CHECK_EQUAL(*executor("*. 3j4 _2"), JArray<JFloat>(Dimensions(2, 2, 2), 5.0, std::atan2(4.0, 3.0),
+							   2.0, std::atan2(0.0, -1.0)));
+
+  BOOST_CHECK_EQUAL(*executor("1 2 3 4 5 -. 2 4"), JArray<JInt>(Dimensions(1, 3), 1, 3, 5));
+  BOOST_CHECK_EQUAL(*executor("1 2 3 -. 2 2 $ 1 2 3 4"), JArray<JInt>(Dimensions(1, 0)));
+  BOOST_CHECK_EQUAL(*executor("(3 2 $ 1 2 3 4 1 2) -. 1 2"), JArray<JInt>(Dimensions(2, 1, 2), 3, 4));
+  BOOST_CHECK_EQUAL(*executor("3 -. 4"), JArray<JInt>(Dimensions(1, 1), 3));
+  BOOST_CHECK_EQUAL(*executor("1.5 2 -. 2"), JArray<JFloat>(Dimensions(1, 1), 1.5));
+  BOOST_CHECK_THROW(executor("+. < 1"), JIllegalValueTypeException);
+  BOOST_CHECK_THROW(executor("-. < 1"), JIllegalValueTypeException);
+}
+
+j_value_type value_type_of(JWord::Ptr word) {
+  return static_cast<const JNoun&>(*word).get_value_type();
+}
+
+BOOST_AUTO_TEST_CASE ( test_narrow_int_types ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(value_type_of(executor("i. 100")), j_value_type_int8);
+  BOOST_CHECK_EQUAL(value_type_of(executor("i. 1000")), j_value_type_int16);
+  BOOST_CHECK_EQUAL(value_type_of(executor("i. 100000")), j_value_type_int);
+  BOOST_CHECK_EQUAL(executor("i. 2 3")->to_string(), JArray<JInt>(Dimensions(2, 2, 3), 0, 1, 2, 3, 4, 5).to_string());
+  BOOST_CHECK_EQUAL(*executor("i. 4"), JArray<JInt8>(Dimensions(1, 4), 0, 1, 2, 3));
+  BOOST_CHECK_EQUAL(*executor("i. 4"), JArray<JInt>(Dimensions(1, 4), 0, 1, 2, 3));
+
+  JWord::Ptr sum(executor("(i. 50) + i. 50"));
+  BOOST_CHECK_EQUAL(value_type_of(sum), j_value_type_int8);
+  BOOST_CHECK_EQUAL(*sum, *executor("2 * i. 50"));
+
+  BOOST_CHECK_EQUAL(value_type_of(executor("(i. 100) * i. 100")), j_value_type_int);
+  BOOST_CHECK_EQUAL(*executor("+/ (i. 100) * i. 100"), JArray<JInt>(Dimensions(0), 328350));
+  BOOST_CHECK_EQUAL(*executor("(i. 2 3) - 2 * i. 2"), JArray<JInt>(Dimensions(2, 2, 3), 0, 1, 2, 1, 2, 3));
+  BOOST_CHECK_EQUAL(value_type_of(executor("(i. 300) - 200")), j_value_type_int);
+  BOOST_CHECK_EQUAL(value_type_of(executor("(i. 300) - i. 300")), j_value_type_int16);
+  BOOST_CHECK_EQUAL(value_type_of(executor("(i. 5) < 3")), j_value_type_bool);
+  BOOST_CHECK_EQUAL(*executor("(i. 4) % 2"), JArray<JFloat>(Dimensions(1, 4), 0.0, 0.5, 1.0, 1.5));
+}
+
+BOOST_AUTO_TEST_CASE ( test_int64_type ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(value_type_of(executor("3000000000")), j_value_type_int64);
+  BOOST_CHECK_EQUAL(value_type_of(executor("3000000000 1 2")), j_value_type_int64);
+  BOOST_CHECK_EQUAL(*executor("3000000000 + 1 2"), 
+		    JArray<JInt64>(Dimensions(1, 2), JInt64(3000000001L), JInt64(3000000002L)));
+  BOOST_CHECK_EQUAL(*executor("+/ 3000000000 3000000000"), JArray<JInt64>(Dimensions(0), JInt64(6000000000L)));
+  BOOST_CHECK_EQUAL(*executor("2 $ 3000000000"), *executor("3000000000 3000000000"));
+  BOOST_CHECK_EQUAL(*executor("(i. 3) + 3000000000"), *executor("3000000000 3000000001 3000000002"));
+}
+
+BOOST_AUTO_TEST_CASE ( test_overflow_promotes_to_float ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(*executor("2000000000 + 2000000000"), JArray<JFloat>(Dimensions(0), 4e9));
+  BOOST_CHECK_EQUAL(*executor("_2000000000 - 2000000000"), JArray<JFloat>(Dimensions(0), -4e9));
+  BOOST_CHECK_EQUAL(*executor("100000 * 100000"), JArray<JFloat>(Dimensions(0), 1e10));
+  BOOST_CHECK_EQUAL(*executor("2000000000 + 1 2000000000"), JArray<JFloat>(Dimensions(1, 2), 2000000001.0, 4e9));
+  BOOST_CHECK_EQUAL(*executor("5000000000000000000 + 5000000000000000000"), JArray<JFloat>(Dimensions(0), 1e19));
+  BOOST_CHECK_EQUAL(value_type_of(executor("2000000000 - 1 2")), j_value_type_int);
+  BOOST_CHECK_EQUAL(*executor("100000 *. 99999"), JArray<JFloat>(Dimensions(0), 9999900000.0));
+  BOOST_CHECK_EQUAL(*executor("100000 4 *. 99999 6"), JArray<JFloat>(Dimensions(1, 2), 9999900000.0, 12.0));
+  BOOST_CHECK_EQUAL(*executor("-. _2147483647"), JArray<JFloat>(Dimensions(0), 2147483648.0));
+  BOOST_CHECK_EQUAL(*executor("3000000000 +. 6"), JArray<JInt64>(Dimensions(0), 6L));
+  BOOST_CHECK_EQUAL(*executor("3000000000 *. 7"), JArray<JInt64>(Dimensions(0), 21000000000L));
+
+  JWord::Ptr scaled(executor("(i. 3000) * 1000000"));
+  BOOST_CHECK_EQUAL(value_type_of(scaled), j_value_type_float);
+  const JArray<JFloat>& values(static_cast<const JArray<JFloat>&>(*scaled));
+  BOOST_CHECK_EQUAL(values.begin()[5], 5e6);
+  BOOST_CHECK_EQUAL(values.begin()[2999], 2.999e9);
+  BOOST_CHECK_EQUAL(value_type_of(executor("(3000 $ 1 2000000) * 1000000")), j_value_type_float);
+  BOOST_CHECK_EQUAL(*executor("(i. 3) + 2147483647"), *executor("0 1 2 + 2147483647"));
+  BOOST_CHECK_EQUAL(value_type_of(executor("(i. 3) + 2147483647")), j_value_type_float);
+
+  BOOST_CHECK_EQUAL(*executor("+/ 2000000000 2000000000"), JArray<JFloat>(Dimensions(0), 4e9));
+  BOOST_CHECK_EQUAL(*executor("+/ 2000000000 2000000000 _2000000000"), JArray<JInt>(Dimensions(0), 2000000000));
+  BOOST_CHECK_EQUAL(*executor("+/ (i. 3000) * 1000"), JArray<JFloat>(Dimensions(0), 4498500000.0));
+}
+
+static bool same_float(JFloat a, JFloat b) {
+  return a == b || (a != a && b != b);
+}
+
+BOOST_AUTO_TEST_CASE ( simd_kernels ) {
+  const std::size_t n = 1000 + 37;
+  vector<JFloat> fl(n), fr(n);
+  vector<JInt> il(n), ir(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    fl[i] = (i % 17) * 0.75 - 4;
+    fr[i] = (i % 13) * 0.5 - 2;
+    il[i] = static_cast<JInt>(i * 7919 % 2001) - 1000;
+    ir[i] = static_cast<JInt>(i * 104729 % 1999) - 999;
+  }
+  fr[5] = std::numeric_limits<JFloat>::quiet_NaN();
+  ir[3] = 0;
+
+  const simd_op ops[] = { simd_op_add, simd_op_subtract, simd_op_multiply, simd_op_divide, 
+			  simd_op_lesser, simd_op_greater, simd_op_lessequal, simd_op_moreequal };
+  const simd_level detected(detected_simd_level());
+  for (int level = simd_level_sse2; level <= detected; ++level) {
+    BOOST_CHECK_EQUAL(set_simd_level(static_cast<simd_level>(level)), level);
+    for (std::size_t k = 0; k < sizeof(ops) / sizeof(ops[0]); ++k) {
+      vector<JFloat> fout(n);
+      vector<JInt> iout(n);
+      vector<JFloat> qout(n);
+      vector<JBitWord> fbits(n / bits_per_word + 1, ~JBitWord(0)), ibits(fbits);
+      bool computed(simd_transform(ops[k], &fl[0], &fr[0], &fout[0], n) || 
+		    simd_transform(ops[k], &fl[0], &fr[0], JBitIterator(&fbits[0], 0), n));
+      BOOST_CHECK(computed);
+      simd_transform(ops[k], &il[0], &ir[0], &iout[0], n);
+      simd_transform(ops[k], &il[0], &ir[0], &qout[0], n);
+      simd_transform(ops[k], &il[0], &ir[0], JBitIterator(&ibits[0], 0), n);
+
+      for (std::size_t i = 0; i < n; ++i) {
+	JFloat a(fl[i]), b(fr[i]);
+	JInt c(il[i]), d(ir[i]);
+	switch (ops[k]) {
+	case simd_op_add: BOOST_CHECK(same_float(fout[i], a + b)); break;
+	case simd_op_subtract: BOOST_CHECK(same_float(fout[i], a - b)); break;
+	case simd_op_multiply: BOOST_CHECK(same_float(fout[i], a * b)); break;
+	case simd_op_divide: 
+	  BOOST_CHECK(same_float(fout[i], a / b));
+	  BOOST_CHECK_EQUAL(qout[i], static_cast<JFloat>(c) / d);
+	  break;
+	case simd_op_lesser: 
+	  BOOST_CHECK(same_float(fout[i], std::min(a, b)));
+	  BOOST_CHECK_EQUAL(iout[i], std::min(c, d));
+	  break;
+	case simd_op_greater: 
+	  BOOST_CHECK(same_float(fout[i], std::max(a, b)));
+	  BOOST_CHECK_EQUAL(iout[i], std::max(c, d));
+	  break;
+	case simd_op_lessequal: 
+	  BOOST_CHECK_EQUAL(bool(JBitIterator(&fbits[0], i)[0]), a <= b);
+	  BOOST_CHECK_EQUAL(bool(JBitIterator(&ibits[0], i)[0]), c <= d);
+	  break;
+	default: 
+	  BOOST_CHECK_EQUAL(bool(JBitIterator(&fbits[0], i)[0]), a >= b);
+	  BOOST_CHECK_EQUAL(bool(JBitIterator(&ibits[0], i)[0]), c >= d);
+	}
+      }
+      if (ops[k] == simd_op_lessequal || ops[k] == simd_op_moreequal) {
+	BOOST_CHECK(*JBitIterator(&fbits[0], n));
+	BOOST_CHECK(*JBitIterator(&ibits[0], n));
+      }
+    }
+
+    bool overflow(true);
+    vector<JInt> checked(n);
+    BOOST_CHECK(simd_checked_transform(simd_op_multiply, &il[0], &ir[0], &checked[0], n, overflow));
+    BOOST_CHECK(!overflow);
+    BOOST_CHECK_EQUAL(checked[n - 1], il[n - 1] * ir[n - 1]);
+    vector<JInt> big(n, 0);
+    for (std::size_t at = 0; at < n; at += 259) {
+      big[at] = 2147483000;
+      BOOST_CHECK(simd_checked_transform(simd_op_add, &big[0], &il[0], &checked[0], n, overflow));
+      BOOST_CHECK_EQUAL(overflow, il[at] > 647);
+      BOOST_CHECK(simd_checked_transform(simd_op_subtract, &il[0], &big[0], &checked[0], n, overflow));
+      BOOST_CHECK_EQUAL(overflow, il[at] < -648);
+      big[at] = 0;
+    }
+  }
+
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  const char* sentences[] = { "(1037 $ 0.5 _1.25 3) + 1037 $ 2 0.25", "(1037 $ 0.5 _1.25 3) <: 1037 $ 2 0.25",
+			      "(1037 $ 5 _7 3) >: 1037 $ 2 9", "(1037 $ 5 _7 3) <. 1037 $ 2 9",
+			      "(1037 $ 5 _7 3) % 1037 $ 2 9", "(1037 $ 50000 _70000 3) * 1037 $ 50000 9",
+			      "(1030 $ 2000000000 1) - 1030 $ _2000000000 1" };
+  for (std::size_t k = 0; k < sizeof(sentences) / sizeof(sentences[0]); ++k) {
+    set_simd_level(simd_level_scalar);
+    JWord::Ptr expected(executor(sentences[k]));
+    for (int level = simd_level_sse2; level <= detected; ++level) {
+      set_simd_level(static_cast<simd_level>(level));
+      BOOST_CHECK_EQUAL(*executor(sentences[k]), *expected);
+    }
+  }
+  BOOST_CHECK_EQUAL(value_type_of(executor("(1037 $ 50000 _70000 3) * 1037 $ 50000 9")), j_value_type_float);
+  set_simd_level(detected);
+}
+
+BOOST_AUTO_TEST_CASE ( test_broadcast_agreement ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(*executor("5 - 2 2 $ 1 2 3 4"), JArray<JInt>(Dimensions(2, 2, 2), 4, 3, 2, 1));
+  BOOST_CHECK_EQUAL(*executor("(2 2 $ 1 2 3 4) - 5"), JArray<JInt>(Dimensions(2, 2, 2), -4, -3, -2, -1));
+  BOOST_CHECK_EQUAL(*executor("(2 3 $ 1 2 3 4 5 6) + 10 20"), 
+		    JArray<JInt>(Dimensions(2, 2, 3), 11, 12, 13, 24, 25, 26));
+  BOOST_CHECK_EQUAL(*executor("10 20 * 2 3 $ 1.5"), 
+		    JArray<JFloat>(Dimensions(2, 2, 3), 15.0, 15.0, 15.0, 30.0, 30.0, 30.0));
+  BOOST_CHECK_EQUAL(*executor("(2 2 $ i. 4) + 1 2"), JArray<JInt>(Dimensions(2, 2, 2), 1, 2, 4, 5));
+  BOOST_CHECK_EQUAL(*executor("1 0 +. 2 2 $ 0 1 0 0"), JArray<JBool>(Dimensions(2, 2, 2), 1, 1, 0, 0));
+
+  BOOST_CHECK_EQUAL(*executor("(i. 3) * 3 700 $ 1"), *executor("3 700 $ (700 $ 0) , (700 $ 1) , 700 $ 2"));
+  BOOST_CHECK_EQUAL(*executor("(3 700 $ 1) * i. 3"), *executor("3 700 $ (700 $ 0) , (700 $ 1) , 700 $ 2"));
+  BOOST_CHECK_EQUAL(*executor("+/ , (3 700 $ 1 2 3) <: 2 1 3"), JArray<JInt>(Dimensions(0), 1400));
+  BOOST_CHECK_EQUAL(*executor("+/ , 0.5 + 3000 $ 1"), JArray<JFloat>(Dimensions(0), 4500.0));
+
+  JWord::Ptr promoted(executor("2000000000 + 3 700 $ 1 2000000000"));
+  BOOST_CHECK_EQUAL(value_type_of(promoted), j_value_type_float);
+  BOOST_CHECK_EQUAL(static_cast<const JArray<JFloat>&>(*promoted).begin()[2099], 4e9);
+}
+
+BOOST_AUTO_TEST_CASE ( test_fused_trains ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK(static_cast<const JVerb&>(*executor("+ * -")).is_monad_elementwise());
+  BOOST_CHECK(static_cast<const JVerb&>(*executor("1 + 2 * -")).is_dyad_elementwise());
+  BOOST_CHECK(!static_cast<const JVerb&>(*executor("+/ * -")).is_monad_elementwise());
+  BOOST_CHECK(!static_cast<const JVerb&>(*executor("1 2 + -")).is_monad_elementwise());
+
+  executor("x =: 10000 $ 0.5 _1.25 3 7");
+  executor("y =: 10000 $ 3 1 4 1 5 9 2 6");
+  BOOST_CHECK_EQUAL(*executor("(+ * -) x"), *executor("(+ x) * - x"));
+  BOOST_CHECK_EQUAL(*executor("(% >:) y"), *executor("y % >: y"));
+  BOOST_CHECK_EQUAL(*executor("(1 + 2 * -) x"), *executor("1 + 2 * - x"));
+  BOOST_CHECK_EQUAL(*executor("x (< +. >) y"), *executor("(x < y) +. x > y"));
+  BOOST_CHECK_EQUAL(*executor("x (- >.) y"), *executor("x - >. y"));
+  BOOST_CHECK_EQUAL(*executor("(+ * -) 100 100 $ x"), *executor("100 100 $ (+ x) * - x"));
+  BOOST_CHECK_EQUAL(*executor("-\"0 x"), *executor("- x"));
+  BOOST_CHECK_EQUAL(*executor("(i. 3) (+ * -) 3 5000 $ 1"), 
+		    *executor("((i. 3) + 3 5000 $ 1) * (i. 3) - 3 5000 $ 1"));
+
+  JWord::Ptr promoted(executor("(+ + +) (10000 $ 1) , 2000000000"));
+  BOOST_CHECK_EQUAL(value_type_of(promoted), j_value_type_float);
+  BOOST_CHECK_EQUAL(static_cast<const JArray<JFloat>&>(*promoted).begin()[0], 2.0);
+  BOOST_CHECK_EQUAL(static_cast<const JArray<JFloat>&>(*promoted).begin()[10000], 4e9);
+}
+
+BOOST_AUTO_TEST_CASE ( test_native_reductions ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  BOOST_CHECK_EQUAL(*executor("+/ 2.5 * i. 5000"), JArray<JFloat>(Dimensions(0), 31243750.0));
+  BOOST_CHECK_EQUAL(*executor("+/ 2500 $ 1 2 3"), JArray<JInt>(Dimensions(0), 4999));
+  BOOST_CHECK_EQUAL(*executor(">./ 5000 $ 3 1 4 1 5 9 2 6"), JArray<JInt>(Dimensions(0), 9));
+  BOOST_CHECK_EQUAL(*executor("<./ 5000 $ 3 1 4 1 5 9 2 6"), JArray<JInt>(Dimensions(0), 1));
+  BOOST_CHECK_EQUAL(*executor("<./ 3000 $ 0.5 _2.5 7"), JArray<JFloat>(Dimensions(0), -2.5));
+  BOOST_CHECK_EQUAL(*executor("*/ 2000 $ 1 _1"), JArray<JInt>(Dimensions(0), 1));
+  BOOST_CHECK_EQUAL(*executor("*/ 40 $ 2"), JArray<JFloat>(Dimensions(0), 1099511627776.0));
+  BOOST_CHECK_EQUAL(*executor("*/ 1 1 0"), JArray<JBool>(Dimensions(0), 0));
+  BOOST_CHECK_EQUAL(*executor(">./ 0 0 1"), JArray<JBool>(Dimensions(0), 1));
+
+  BOOST_CHECK_EQUAL(*executor("+/ 3 4 $ i. 12"), JArray<JInt>(Dimensions(1, 4), 12, 15, 18, 21));
+  BOOST_CHECK_EQUAL(*executor("<./ 2 3 $ 1.5 _2 7 0.5 3 _8"), JArray<JFloat>(Dimensions(1, 3), 0.5, -2.0, -8.0));
+  BOOST_CHECK_EQUAL(*executor(">./ 1500 2 $ i. 3000"), JArray<JInt>(Dimensions(1, 2), 2998, 2999));
+  BOOST_CHECK_EQUAL(*executor("+/ 3 2 $ 2000000000"), JArray<JFloat>(Dimensions(1, 2), 6e9, 6e9));
+
+  BOOST_CHECK_EQUAL(*executor("+/\"1 (i. 3 4)"), JArray<JInt>(Dimensions(1, 3), 6, 22, 38));
+  BOOST_CHECK_EQUAL(*executor("+/\"_1 (i. 3 4)"), JArray<JInt>(Dimensions(1, 3), 6, 22, 38));
+  BOOST_CHECK_EQUAL(*executor(">./\"1 (2 40 $ 0.5 7.5 _3)"), JArray<JFloat>(Dimensions(1, 2), 7.5, 7.5));
+  BOOST_CHECK_EQUAL(*executor("<./\"1 (2 40 $ 0.5 7.5 _3)"), JArray<JFloat>(Dimensions(1, 2), -3.0, -3.0));
+  BOOST_CHECK_EQUAL(*executor("*/\"1 (2 3 $ 1 2 3 4 5 6)"), JArray<JInt>(Dimensions(1, 2), 6, 120));
+  BOOST_CHECK_EQUAL(*executor("+/\"2 (i. 2 2 3)"), JArray<JInt>(Dimensions(2, 2, 3), 3, 5, 7, 15, 17, 19));
+  BOOST_CHECK_EQUAL(*executor("+/\"1 (2 3000 $ 1 2 3)"), JArray<JInt>(Dimensions(1, 2), 6000, 6000));
+  BOOST_CHECK_EQUAL(*executor("+/\"1 (2 3 $ 2000000000)"), JArray<JFloat>(Dimensions(1, 2), 6e9, 6e9));
+  BOOST_CHECK_EQUAL(*executor("*/\"1 (2 3 $ 1 1 0 1 1 1)"), JArray<JBool>(Dimensions(1, 2), 0, 1));
+}
+
+BOOST_AUTO_TEST_CASE ( test_lazy_progressions ) {
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+
+  JWord::Ptr shifted(executor("5 + i. 10"));
+  BOOST_CHECK(static_cast<const JNoun&>(*shifted).get_progression());
+  BOOST_CHECK_EQUAL(*executor("5 + i. 10"), *executor("5 6 7 8 9 10 11 12 13 14"));
+  BOOST_CHECK_EQUAL(*executor("10 - 2 * i. 4"), JArray<JInt>(Dimensions(1, 4), 10, 8, 6, 4));
+  BOOST_CHECK_EQUAL(*executor("(i. 4) + i. 4"), JArray<JInt>(Dimensions(1, 4), 0, 2, 4, 6));
+  BOOST_CHECK_EQUAL(*executor("i. _4"), JArray<JInt>(Dimensions(1, 4), 3, 2, 1, 0));
+  BOOST_CHECK_EQUAL(*executor("i. 2 3"), JArray<JInt>(Dimensions(2, 2, 3), 0, 1, 2, 3, 4, 5));
+  BOOST_CHECK_EQUAL(*executor("2 2 $ i. 10"), JArray<JInt>(Dimensions(2, 2, 2), 0, 1, 2, 3));
+  BOOST_CHECK(static_cast<const JNoun&>(*executor("2 2 $ i. 10")).get_progression());
+
+  BOOST_CHECK_EQUAL(*executor("+/ i. 100000"), JArray<JFloat>(Dimensions(0), 4999950000.0));
+  BOOST_CHECK_EQUAL(*executor("+/ i. 1000"), JArray<JInt>(Dimensions(0), 499500));
+  BOOST_CHECK_EQUAL(*executor("+/ i. 10000000000"), JArray<JFloat>(Dimensions(0), 49999999995000000000.0));
+  BOOST_CHECK_EQUAL(value_type_of(executor("3000000000 + i. 10")), j_value_type_int64);
+
+  JWord::Ptr widened(executor("10 * i. 1000000000"));
+  BOOST_CHECK(static_cast<const JNoun&>(*widened).get_progression());
+  BOOST_CHECK_EQUAL(value_type_of(widened), j_value_type_float);
+  BOOST_CHECK_EQUAL(static_cast<const JNoun&>(*widened).get_progression()->step, 10);
+  BOOST_CHECK_EQUAL(*executor("+/ 10 * i. 1000000000"), JArray<JFloat>(Dimensions(0), 4999999995000000000.0));
+  BOOST_CHECK_EQUAL(*executor("3 $ 10 * i. 1000000000"), JArray<JFloat>(Dimensions(1, 3), 0.0, 10.0, 20.0));
+  JWord::Ptr float_shifted(executor("1 + 1000000000 * i. 5"));
+  BOOST_CHECK(!static_cast<const JNoun&>(*float_shifted).get_progression());
+  BOOST_CHECK_EQUAL(*float_shifted, JArray<JFloat>(Dimensions(1, 5), 1.0, 1e9 + 1, 2e9 + 1, 3e9 + 1, 4e9 + 1));
+}
+
+BOOST_AUTO_TEST_CASE ( test_strided_views ) {
+  JArray<JInt> arr(Dimensions(2, 2, 3), 0, 1, 2, 3, 4, 5);
+  vector<int> swap_axes;
+  swap_axes.push_back(1);
+  swap_axes.push_back(0);
+
+  JNoun::Ptr transposed(arr.transpose(swap_axes));
+  const JArray<JInt>& columns(static_cast<const JArray<JInt>&>(*transposed));
+  BOOST_CHECK(columns.is_strided());
+
+  JArray<JInt> column(columns[1]);
+  BOOST_CHECK(column.is_strided());
+  BOOST_CHECK(!arr.has_unique_content());
+  BOOST_CHECK_EQUAL(column, JArray<JInt>(Dimensions(1, 2), 1, 4));
+  BOOST_CHECK_EQUAL(*columns.transpose(swap_axes), arr);
+  BOOST_CHECK(!static_cast<const JArray<JInt>&>(*columns.transpose(swap_axes)).is_strided());
+
+  shared_ptr<JMachine> m(JMachine::new_machine());
+  JExecutor executor(m);
+  BOOST_CHECK_EQUAL(*executor("|: 2 3 $ 0 1 2 3 4 5"), JArray<JInt>(Dimensions(2, 3, 2), 0, 3, 1, 4, 2, 5));
+  BOOST_CHECK_EQUAL(*executor("|. 2 3 $ 0 1 2 3 4 5"), JArray<JInt>(Dimensions(2, 2, 3), 3, 4, 5, 0, 1, 2));
+  BOOST_CHECK_EQUAL(*executor("|. |: 2 3 $ 0 1 2 3 4 5"), JArray<JInt>(Dimensions(2, 3, 2), 2, 5, 1, 4, 0, 3));
+  BOOST_CHECK_EQUAL(*executor("0 |: 2 3 $ 0 1 2 3 4 5"), JArray<JInt>(Dimensions(2, 3, 2), 0, 3, 1, 4, 2, 5));
+  BOOST_CHECK_EQUAL(*executor("1 |. 0 1 2 3 4"), JArray<JInt>(Dimensions(1, 5), 1, 2, 3, 4, 0));
+  BOOST_CHECK_EQUAL(*executor("_1 |. 0 1 2 3 4"), JArray<JInt>(Dimensions(1, 5), 4, 0, 1, 2, 3));
+  BOOST_CHECK_EQUAL(*executor("+/\"1 (|: 2 3 $ 0 1 2 3 4 5)"), JArray<JInt>(Dimensions(1, 3), 3, 5, 7));
+  BOOST_CHECK_EQUAL(*executor("10 + |: 2 3 $ 0 1 2 3 4 5"), JArray<JInt>(Dimensions(2, 3, 2), 10, 13, 11, 14, 12, 15));
+}
+
 BOOST_AUTO_TEST_CASE ( test_i_dot_verb ) {
   JArray<JInt> arr(Dimensions(2,2,3), 1,2,3,4,-5,6);
   shared_ptr<JMachine> m(JMachine::new_machine());
@@ -394,7 +1325,7 @@ BOOST_AUTO_TEST_CASE ( test_i_dot_monad_verb ) {
 
 BOOST_AUTO_TEST_CASE ( test_adverb ) { 
   shared_ptr<JMachine> m(JMachine::new_machine());
-  shared_ptr<PlusVerb> plus(new PlusVerb);;
+  intrusive_ptr<PlusVerb> plus(new PlusVerb);;
   JInsertTableAdverb adverb;
   JVerb verb(static_cast<JVerb&>(*adverb(m, plus)));
   BOOST_CHECK_EQUAL(*verb(m, JArray<JInt>(Dimensions(1,10), 1, 2, 3, 4, 5, 6, 7, 8, 9, 10)),
@@ -470,18 +1401,18 @@ BOOST_AUTO_TEST_CASE ( test_prefix_infix_adverb ) {
 
 BOOST_AUTO_TEST_CASE ( test_rank_conjunction ) {
   shared_ptr<JMachine> m(JMachine::new_machine());
-  shared_ptr<PlusVerb> plus(new PlusVerb);
-  shared_ptr<JVerb> sum(boost::static_pointer_cast<JVerb>(JInsertTableAdverb()(m, plus)));
-  shared_ptr<JNoun> rank_array(new JArray<JInt>(Dimensions(1,3), 1, 0, 0));
-  shared_ptr<JVerb> sum_rank(boost::static_pointer_cast<JVerb>(RankConjunction()(m, sum, rank_array)));
+  intrusive_ptr<PlusVerb> plus(new PlusVerb);
+  JVerb::Ptr sum(boost::static_pointer_cast<JVerb>(JInsertTableAdverb()(m, plus)));
+  JNoun::Ptr rank_array(new JArray<JInt>(Dimensions(1,3), 1, 0, 0));
+  JVerb::Ptr sum_rank(boost::static_pointer_cast<JVerb>(RankConjunction()(m, sum, rank_array)));
   
   JArray<JInt> test_subject(Dimensions(2, 2, 5), 1,2,3,4,5,6,7,8,9,10);
 
   BOOST_CHECK_EQUAL(*(*sum_rank)(m, test_subject), JArray<JInt>(Dimensions(1,2), 15, 40));
   BOOST_CHECK_EQUAL(*(*sum)(m, test_subject), JArray<JInt>(Dimensions(1,5), 7,9,11,13,15));
 
-  shared_ptr<JNoun> rank_array2(new JArray<JInt>(Dimensions(1,3), -1, 0, 0));
-  shared_ptr<JVerb> sum_rank2(boost::static_pointer_cast<JVerb>(RankConjunction()(m, sum, rank_array2)));
+  JNoun::Ptr rank_array2(new JArray<JInt>(Dimensions(1,3), -1, 0, 0));
+  JVerb::Ptr sum_rank2(boost::static_pointer_cast<JVerb>(RankConjunction()(m, sum, rank_array2)));
   JArray<JInt> test_subject2(Dimensions(3, 2,3,4), 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24);
   BOOST_CHECK_EQUAL(*(*sum_rank2)(m, test_subject2), JArray<JInt>(Dimensions(2, 2,4), 15,18,21,24,51,54,57,60));
 }
@@ -768,7 +1699,7 @@ BOOST_AUTO_TEST_CASE ( transformation_rule0 ) {
   lst.insert(lst.end(), JTokenLParen::Instantiate());
   lst.insert(lst.end(), JTokenOperator::Instantiate("-"));
   lst.insert(lst.end(), 
-	     JTokenWord<JNoun>::Instantiate(shared_ptr<JNoun>(new JArray<JInt>(Dimensions(2,2,2), 0, 1,2,3))));
+	     JTokenWord<JNoun>::Instantiate(JNoun::Ptr(new JArray<JInt>(Dimensions(2,2,2), 0, 1,2,3))));
   lst.insert(lst.end(), JTokenRParen::Instantiate());
   
   BOOST_CHECK(monad0(&lst, lst.begin()));
@@ -788,7 +1719,7 @@ BOOST_AUTO_TEST_CASE ( transformation_rule1 ) {
   lst.insert(lst.end(), JTokenOperator::Instantiate("-"));
   lst.insert(lst.end(), JTokenOperator::Instantiate("-"));
   lst.insert(lst.end(), JTokenWord<JNoun>::Instantiate
-	     (shared_ptr<JNoun>(new JArray<JInt>(Dimensions(1, 3), 1,  2,  3))));
+	     (JNoun::Ptr(new JArray<JInt>(Dimensions(1, 3), 1,  2,  3))));
   
   BOOST_CHECK(monad1(&lst, lst.begin()));
   BOOST_CHECK_EQUAL(lst.size(), 3);
@@ -803,10 +1734,10 @@ BOOST_AUTO_TEST_CASE ( transformation_rule2 ) {
   list<JTokenBase::Ptr> lst;
   lst.insert(lst.end(), JTokenLParen::Instantiate());
   lst.insert(lst.end(), JTokenWord<JNoun>::Instantiate
-	     (shared_ptr<JNoun>(new JArray<JInt>(Dimensions(2, 3, 2), 6,  2,  3, 1, 2, 3))));
+	     (JNoun::Ptr(new JArray<JInt>(Dimensions(2, 3, 2), 6,  2,  3, 1, 2, 3))));
   lst.insert(lst.end(), JTokenOperator::Instantiate("-"));
   lst.insert(lst.end(), JTokenWord<JNoun>::Instantiate
-	     (shared_ptr<JNoun>(new JArray<JInt>(Dimensions(1, 3), 1,  2,  3))));
+	     (JNoun::Ptr(new JArray<JInt>(Dimensions(1, 3), 1,  2,  3))));
   
   BOOST_CHECK(rule(&lst, lst.begin()));
   BOOST_CHECK_EQUAL(lst.size(), 2);
@@ -1081,7 +2012,7 @@ BOOST_AUTO_TEST_CASE ( executor_shape_test ) {
   BOOST_CHECK_EQUAL(*executor("0 0 $ 0 0 10 $ 0"), 
 		    JArray<JInt>(Dimensions(4, 0, 0, 0, 10)));
   BOOST_CHECK_THROW(*executor("2 2 $ 0 10 10 $ 10"), 
-		    JIllegalDimensionsException)
+		    JIllegalDimensionsException);
 }
 
 BOOST_AUTO_TEST_CASE ( test_ravel_append ) {
@@ -2,17 +2,17 @@
 
 namespace J {
 VectorCounter::VectorCounter(const Dimensions &dims): 
-  dims(dims), v(vector<int>(dims.get_rank(), 0)) {}
+  dims(dims), v(vector<JSize>(dims.get_rank(), 0)) {}
   
-pair<int, int> add_row(VectorCounter& one, VectorCounter& two) { 
+pair<JSize, JSize> add_row(VectorCounter& one, VectorCounter& two) { 
   int onerank = one.get_rank();
   int tworank = two.get_rank();
   assert(onerank >= 1);
   assert(tworank >= 1);
-  return pair<int, int>(one.dims[onerank - 1], (add_pos(one, two, onerank - 2) + 1) * two.dims[tworank - 1]);
+  return pair<JSize, JSize>(one.dims[onerank - 1], (add_pos(one, two, onerank - 2) + 1) * two.dims[tworank - 1]);
 }
 
-int add_pos(VectorCounter &one, VectorCounter& two, int pos) { 
+JSize add_pos(VectorCounter &one, VectorCounter& two, int pos) { 
   if (pos < 0) return 0;
   assert(one.dims[pos] <= two.dims[pos]);
     
@@ -56,16 +56,16 @@ OperationIteratorBase& OperationIteratorBase::operator++() {
 template <typename T>
 OperationIterator<T>::OperationIterator(const JArray<T>& c, const Dimensions& frame, int output_rank):
   OperationIteratorBase(frame, c.get_dims(), output_rank),
-  content(c), ptr(c.begin()), iterator_increment(output.number_of_elems()) {}
+  content(c), position(0), iterator_increment(output.number_of_elems()) {}
   
 template <typename T>
 void OperationIterator<T>::increment_iterator() { 
-  ptr += iterator_increment;
+  position += iterator_increment;
 }
 
 template <typename T>
-shared_ptr<JNoun> OperationIterator<T>::operator*() const {
-  shared_ptr<JNoun> p(new JArray<T>(output, content, ptr, ptr + iterator_increment));
+JNoun::Ptr OperationIterator<T>::operator*() const {
+  JNoun::Ptr p(new JArray<T>(content.slice(output, position)));
   return p;
 }
 
@@ -107,6 +107,10 @@ string escape_regex(const string& s) {
   return ss.str();
 }
 
+bool longer_string(const string& s1, const string& s2) {
+  return s1.size() > s2.size();
+}
+
 bool escape_char_p(char c) { 
   const char to_escape[] = {'^', '.', '$', '|', '(', ')', '[', ']', '*', '+', '?', '\\', '/'};
   for (unsigned i = 0; i < sizeof(to_escape); ++i ) {
@@ -126,11 +130,19 @@ string trim_string(const string& str) {
   return string(start_iterator, end_iterator.base());
 }
 
+template class OperationScalarIterator<JBool>;
+template class OperationScalarIterator<JInt8>;
+template class OperationScalarIterator<JInt16>;
 template class OperationScalarIterator<JInt>;
+template class OperationScalarIterator<JInt64>;
 template class OperationScalarIterator<JFloat>;
 template class OperationScalarIterator<JBox>;
 template class OperationScalarIterator<JComplex>;
+template class OperationIterator<JBool>;
+template class OperationIterator<JInt8>;
+template class OperationIterator<JInt16>;
 template class OperationIterator<JInt>;
+template class OperationIterator<JInt64>;
 template class OperationIterator<JFloat>;
 template class OperationIterator<JBox>;
 template class OperationIterator<JComplex>;
@@ -15,15 +15,15 @@ using boost::make_shared;
 
 class VectorCounter { 
   Dimensions dims;
-  vector<int> v;
+  vector<JSize> v;
     
 public:
   VectorCounter(const Dimensions& dims);
     
   int get_rank() const { return dims.get_rank(); }
 
-  friend pair<int, int> add_row(VectorCounter &one, VectorCounter& two);
-  friend int add_pos(VectorCounter& one, VectorCounter& two, int pos);
+  friend pair<JSize, JSize> add_row(VectorCounter &one, VectorCounter& two);
+  friend JSize add_pos(VectorCounter& one, VectorCounter& two, int pos);
 };
 
 class OperationIteratorBase {
@@ -32,7 +32,7 @@ protected:
   
 private:
   Dimensions frame;
-  int iterator_increment_periodicity, counter_end, counter;
+  JSize iterator_increment_periodicity, counter_end, counter;
     
 public:
   typedef shared_ptr<OperationIteratorBase> Ptr;
@@ -52,11 +52,10 @@ protected:
 template <typename T> 
 class OperationIterator: public OperationIteratorBase { 
   typedef JArray<T> container;
-  typedef typename container::iter iterator;
 
   container content;
-  iterator ptr;
-  int iterator_increment;
+  JSize position;
+  JSize iterator_increment;
 
 protected:
   void increment_iterator();
@@ -74,8 +73,8 @@ class OperationScalarIterator {
 
   JArray<T> content;
   Dimensions frame;
-  int iterator_increment_periodicity;
-  int counter_end, counter;
+  JSize iterator_increment_periodicity;
+  JSize counter_end, counter;
   iterator ptr;
 
 public:
@@ -123,14 +122,15 @@ template <typename T>
 JArray<T> expand_to_rank(int rank, const JArray<T>& array) {
   assert(rank >= array.get_rank());
   Dimensions old_dims(array.get_dims());
-  shared_ptr<vector<int> > new_dims_vector(new vector<int>(rank, 1));
+  vector<JSize> new_dims_vector(rank, 1);
 
-  copy(old_dims.begin(), old_dims.end(), new_dims_vector->begin() + (rank - array.get_rank()));
-  return JArray<T>(new_dims_vector, array.get_content());
+  copy(old_dims.begin(), old_dims.end(), new_dims_vector.begin() + (rank - array.get_rank()));
+  return array.slice(Dimensions::from_range(new_dims_vector.begin(), new_dims_vector.end()), 0);
 }
   
 bool escape_char_p(char c);
 string escape_regex(const string& s);
+bool longer_string(const string& s1, const string& s2);
 string trim_string(const string& s); 
 }
 